@@ -13,15 +13,18 @@
 #include "mir/action/plan/Job.h"
 
 #include <algorithm>
+#include <sstream>
 
 #include "mir/action/context/Context.h"
 #include "mir/action/io/Copy.h"
 #include "mir/action/plan/ActionPlan.h"
+#include "mir/action/plan/PlanCache.h"
 #include "mir/api/MIRJob.h"
 #include "mir/config/LibMir.h"
 #include "mir/input/MIRInput.h"
 #include "mir/key/style/MIRStyle.h"
 #include "mir/param/CombinedParametrisation.h"
+#include "mir/param/TrackingParametrisation.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
 #include "mir/util/MIRStatistics.h"
@@ -30,59 +33,105 @@
 namespace mir::action {
 
 
-Job::Job(const api::MIRJob& job, input::MIRInput& input, output::MIROutput& output, bool compress) :
-    input_(input), output_(output) {
-
-    // get input and parameter-specific parametrisations
-    const param::MIRParametrisation& metadata = input.parametrisation();
-
-    combined_ = std::make_unique<param::CombinedParametrisation>(job, metadata);
-    plan_     = std::make_unique<ActionPlan>(*combined_);
-
+static void prepare(const api::MIRJob& job, const param::MIRParametrisation& metadata,
+                    const param::MIRParametrisation& combined, ActionPlan& plan, output::MIROutput& output,
+                    bool compress) {
 
     // skip preparing an Action plan if nothing to do, or input is already what was specified
     const auto& ppKeys = LibMir::postProcessKeys();
     if (!std::any_of(ppKeys.begin(), ppKeys.end(), [&job](const std::string& k) { return job.has(k); }) &&
         job.matchAll(metadata)) {
-        plan_->add(new io::Copy(*combined_, output_));
+        plan.add(new io::Copy(combined, output));
     }
     else {
-        std::unique_ptr<key::style::MIRStyle> style(key::style::MIRStyleFactory::build(*combined_));
-        style->prepare(*plan_, output_);
+        std::unique_ptr<key::style::MIRStyle> style(key::style::MIRStyleFactory::build(combined));
+        style->prepare(plan, output);
 
         if (compress) {
-            plan_->compress();
+            plan.compress();
         }
     }
 
     if (Log::debug_active()) {
-        plan_->dump(Log::debug() << "Action plan is:"
-                                    "\n");
+        plan.dump(Log::debug() << "Action plan is:"
+                                  "\n");
     }
 
-    ASSERT(plan_->ended());
+    ASSERT(plan.ended());
 }
 
 
-Job::~Job() = default;
+Job::Job(const api::MIRJob& job, input::MIRInput& input, output::MIROutput& output, bool compress) :
+    input_(input), output_(output), cache_(nullptr), entry_(nullptr) {
+
+    // get input and parameter-specific parametrisations
+    const param::MIRParametrisation& metadata = input.parametrisation();
 
+    combined_ = std::make_unique<param::CombinedParametrisation>(job, metadata);
+    plan_     = std::make_unique<ActionPlan>(*combined_);
 
-void Job::execute(util::MIRStatistics& statistics) const {
-    ASSERT(plan_);
+    prepare(job, metadata, *combined_, *plan_, output_, compress);
+}
+
+
+Job::Job(const api::MIRJob& job, input::MIRInput& input, output::MIROutput& output, bool compress,
+         PlanCache& cache) :
+    input_(input), output_(output), cache_(&cache), entry_(nullptr) {
 
+    // get input and parameter-specific parametrisations
+    const param::MIRParametrisation& metadata = input.parametrisation();
+
+    // plans depend on the job, output (referenced by the plan) and (consulted) field metadata
+    std::ostringstream key;
+    key << job << " " << output.id() << " " << compress;
+
+    if ((entry_ = cache.acquire(key.str(), metadata)) != nullptr) {
+        Log::debug() << "Job: reusing action plan" << std::endl;
+        return;
+    }
+
+    // build plan recording the consulted field metadata
+    auto entry = std::make_unique<PlanCache::Entry>();
+    entry->key = key.str();
+
+    entry->field = std::make_unique<param::TrackingParametrisation>(metadata);
+    entry->field->record(true);
+
+    entry->combined = std::make_unique<param::CombinedParametrisation>(job, *entry->field);
+    entry->plan     = std::make_unique<ActionPlan>(*entry->combined);
+
+    prepare(job, *entry->field, *entry->combined, *entry->plan, output_, compress);
+    entry->field->record(false);
+
+    Log::debug() << "Job: caching action plan (" << entry->field->recorded() << " metadata lookups)" << std::endl;
+    entry_ = cache.insert(std::move(entry));
+}
+
+
+Job::~Job() {
+    if (entry_ != nullptr) {
+        cache_->release(entry_);
+    }
+}
+
+
+void Job::execute(util::MIRStatistics& statistics) const {
     context::Context ctx(input_, statistics);
-    plan_->execute(ctx);
+    plan().execute(ctx);
 }
 
 
 const ActionPlan& Job::plan() const {
-    return *plan_;
+    const auto& plan = entry_ != nullptr ? entry_->plan : plan_;
+    ASSERT(plan);
+    return *plan;
 }
 
 
 const param::MIRParametrisation& Job::parametrisation() const {
-    ASSERT(combined_);
-    return *combined_;
+    const auto& combined = entry_ != nullptr ? entry_->combined : combined_;
+    ASSERT(combined);
+    return *combined;
 }
 
 
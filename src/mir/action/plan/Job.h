@@ -14,6 +14,8 @@
 
 #include <memory>
 
+#include "mir/action/plan/PlanCache.h"
+
 
 namespace mir {
 namespace action {
@@ -49,6 +51,12 @@ public:
 
     Job(const api::MIRJob&, input::MIRInput&, output::MIROutput&, bool compress);
 
+    /// Reuse (or build and cache) an action plan for the job and consulted input metadata
+    Job(const api::MIRJob&, input::MIRInput&, output::MIROutput&, bool compress, PlanCache&);
+
+    Job(const Job&) = delete;
+    Job(Job&&)      = delete;
+
     // -- Destructor
 
     ~Job();
@@ -57,7 +65,9 @@ public:
     // None
 
     // -- Operators
-    // None
+
+    void operator=(const Job&) = delete;
+    void operator=(Job&&)      = delete;
 
     // -- Methods
 
@@ -99,6 +109,8 @@ private:
     output::MIROutput& output_;
     std::unique_ptr<const param::MIRParametrisation> combined_;
     std::unique_ptr<ActionPlan> plan_;
+    PlanCache* cache_;
+    PlanCache::Entry* entry_;
 
     // -- Methods
     // None
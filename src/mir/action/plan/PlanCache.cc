@@ -0,0 +1,86 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/action/plan/PlanCache.h"
+
+#include "mir/action/plan/ActionPlan.h"
+#include "mir/param/TrackingParametrisation.h"
+#include "mir/util/Exceptions.h"
+
+
+namespace mir::action {
+
+
+PlanCache::Entry::Entry() = default;
+
+
+PlanCache::Entry::~Entry() = default;
+
+
+PlanCache::PlanCache(size_t capacity) : capacity_(capacity), hits_(0) {}
+
+
+PlanCache::~PlanCache() = default;
+
+
+PlanCache::Entry* PlanCache::acquire(const std::string& key, const param::MIRParametrisation& metadata) {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
+
+    for (auto j = entries_.begin(); j != entries_.end(); ++j) {
+        auto& entry = **j;
+        if (!entry.busy && entry.key == key && entry.field->matches(metadata)) {
+            entry.field->target(metadata);
+            entry.busy = true;
+            hits_++;
+
+            entries_.splice(entries_.begin(), entries_, j);
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+
+PlanCache::Entry* PlanCache::insert(std::unique_ptr<Entry>&& entry) {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
+
+    ASSERT(entry && entry->field && entry->combined && entry->plan);
+    entry->busy = true;
+
+    entries_.push_front(std::move(entry));
+
+    for (auto j = entries_.end(); entries_.size() > capacity_ && j != entries_.begin();) {
+        if (!(*--j)->busy) {
+            j = entries_.erase(j);
+        }
+    }
+
+    return entries_.front().get();
+}
+
+
+void PlanCache::release(Entry* entry) {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
+
+    ASSERT(entry != nullptr && entry->busy);
+    entry->busy = false;
+}
+
+
+size_t PlanCache::hits() const {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
+    return hits_;
+}
+
+
+}  // namespace mir::action
@@ -0,0 +1,101 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+
+#include "mir/util/Mutex.h"
+
+
+namespace mir {
+namespace action {
+class ActionPlan;
+}
+namespace param {
+class MIRParametrisation;
+class TrackingParametrisation;
+}  // namespace param
+}  // namespace mir
+
+
+namespace mir::action {
+
+
+/**
+ * Compiled action plans, per job (key) and the field metadata consulted to build them: fields answering the same to
+ * the recorded metadata lookups reuse the plan, with its field parametrisation forwarding to the new field. Plans are
+ * acquired for exclusive use (concurrent jobs build their own).
+ */
+class PlanCache {
+public:
+    // -- Types
+
+    struct Entry {
+        Entry();
+        ~Entry();
+
+        Entry(const Entry&) = delete;
+        Entry(Entry&&)      = delete;
+
+        void operator=(const Entry&) = delete;
+        void operator=(Entry&&)      = delete;
+
+        std::unique_ptr<param::TrackingParametrisation> field;
+        std::unique_ptr<const param::MIRParametrisation> combined;
+        std::unique_ptr<ActionPlan> plan;
+        std::string key;
+        bool busy = false;
+    };
+
+    // -- Constructors
+
+    explicit PlanCache(size_t capacity = 64);
+
+    PlanCache(const PlanCache&) = delete;
+    PlanCache(PlanCache&&)      = delete;
+
+    // -- Destructor
+
+    ~PlanCache();
+
+    // -- Operators
+
+    void operator=(const PlanCache&) = delete;
+    void operator=(PlanCache&&)      = delete;
+
+    // -- Methods
+
+    /// Acquire a plan matching key and field metadata (forwarding to it), nullptr if not found
+    Entry* acquire(const std::string& key, const param::MIRParametrisation& metadata);
+
+    /// Insert (acquired) plan, evicting the least recently used plan if over capacity
+    Entry* insert(std::unique_ptr<Entry>&&);
+
+    void release(Entry*);
+
+    /// Number of plans reused
+    size_t hits() const;
+
+private:
+    // -- Members
+
+    const size_t capacity_;
+    size_t hits_;
+    std::list<std::unique_ptr<Entry>> entries_;  // most recently used first
+    mutable util::recursive_mutex mutex_;
+};
+
+
+}  // namespace mir::action
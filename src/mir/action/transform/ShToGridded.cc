@@ -12,6 +12,7 @@
 
 #include "mir/action/transform/ShToGridded.h"
 
+#include <memory>
 #include <ostream>
 #include <sstream>
 
@@ -30,8 +31,10 @@
 #include "mir/repres/Representation.h"
 #include "mir/util/Domain.h"
 #include "mir/util/Exceptions.h"
+#include "mir/util/KeyedMutex.h"
 #include "mir/util/MIRStatistics.h"
 #include "mir/util/Mutex.h"
+#include "mir/util/Parallel.h"
 #include "mir/util/Trace.h"
 
 
@@ -44,6 +47,11 @@ static caching::InMemoryCache<TransCache> trans_cache("mirCoefficient", CAPACITY
                                                       "$MIR_COEFFICIENT_CACHE");
 
 
+// spectral transforms (Atlas/ectrans, FFTW plans) are not thread-safe: their creation (including for Legendre
+// coefficients), execution and destruction are serialised, caching is not
+static util::recursive_mutex trans_mutex;
+
+
 static atlas::trans::Cache getTransCache(atlas::trans::LegendreCacheCreator& creator, const std::string& key,
                                          const param::MIRParametrisation& parametrisation, context::Context& ctx) {
     auto j = trans_cache.find(key);
@@ -66,6 +74,7 @@ static atlas::trans::Cache getTransCache(atlas::trans::LegendreCacheCreator& cre
         class LegendreCacheCreator final : public caching::LegendreCache::CacheContentCreator {
 
             atlas::trans::LegendreCacheCreator& creator_;
+            const param::MIRParametrisation& parametrisation_;
             context::Context& ctx_;
 
             void create(const eckit::PathName& path, caching::LegendreCacheTraits::value_type& /*ignore*/,
@@ -73,16 +82,19 @@ static atlas::trans::Cache getTransCache(atlas::trans::LegendreCacheCreator& cre
                 trace::ResourceUsage usage("ShToGridded: create Legendre coefficients");
                 auto timing(ctx_.statistics().createCoeffTimer());
 
-                // This will create the cache
+                // This will create the cache (with OpenMP threads, if configured)
                 Log::info() << "ShToGridded: create Legendre coefficients '" + path + "'" << std::endl;
+                util::lock_guard<util::recursive_mutex> guard(trans_mutex);
+                util::parallel_omp_num_threads(parametrisation_);
                 creator_.create(path);
 
                 saved = path.exists();
             }
 
         public:
-            LegendreCacheCreator(atlas::trans::LegendreCacheCreator& creator, context::Context& ctx) :
-                creator_(creator), ctx_(ctx) {}
+            LegendreCacheCreator(atlas::trans::LegendreCacheCreator& creator,
+                                 const param::MIRParametrisation& parametrisation, context::Context& ctx) :
+                creator_(creator), parametrisation_(parametrisation), ctx_(ctx) {}
             ~LegendreCacheCreator() override = default;
 
             LegendreCacheCreator(const LegendreCacheCreator&)            = delete;
@@ -92,14 +104,16 @@ static atlas::trans::Cache getTransCache(atlas::trans::LegendreCacheCreator& cre
         };
 
         static caching::LegendreCache cache;
-        LegendreCacheCreator create(creator, ctx);
+        LegendreCacheCreator create(creator, parametrisation, ctx);
 
         int dummy = 0;
         path      = cache.getOrCreate(key, create, dummy);
     }
 
 
-    TransCache& tc                  = trans_cache[key];
+    // entry is inserted complete, as it is visible to other threads
+    std::unique_ptr<TransCache> entry(new TransCache);
+    TransCache& tc                  = *entry;
     atlas::trans::Cache& transCache = tc.transCache_;
 
     {
@@ -122,10 +136,12 @@ static atlas::trans::Cache getTransCache(atlas::trans::LegendreCacheCreator& cre
         size_t memory                                    = 0;
         size_t shared                                    = 0;
         (tc.loader_->inSharedMemory() ? shared : memory) = tc.loader_->size();
+
+        ASSERT(transCache);
+        trans_cache.insert(key, entry.release());
         trans_cache.footprint(key, caching::InMemoryCacheUsage(memory, shared));
     }
 
-    ASSERT(transCache);
     return transCache;
 }
 
@@ -139,9 +155,6 @@ static eckit::Hash::digest_t atlasOptionsDigest(const ShToGridded::atlas_config_
 
 void ShToGridded::transform(data::MIRField& field, const repres::Representation& representation,
                             context::Context& ctx) const {
-    static util::recursive_mutex local_mutex;
-    util::lock_guard<util::recursive_mutex> lock(local_mutex);  // To protect trans_cache
-
     // Make sure another thread to no evict anything from the cache while we are using it
     // FIXME check if it should be in ::execute()
     auto cacheUse(ctx.statistics().cacheUser(trans_cache));
@@ -171,49 +184,70 @@ void ShToGridded::transform(data::MIRField& field, const repres::Representation&
     const std::string key(creator.uid());
     ASSERT(!key.empty());
 
-    atlas_trans_t trans;
+    // entry is not purged while in use, even if another thread forces purging (see getTransCache)
+    caching::InMemoryCachePin<TransCache> pin(trans_cache, key);
+
+    atlas::trans::Cache transCache;
     try {
         trace::Timer time("ShToGridded::caching");
 
         bool caching = LibMir::caching();
         parametrisation().get("caching", caching);
 
+        // single-flight: threads requiring the same coefficients wait for the first one to create them, others (and
+        // cache hits) are not blocked
+        static util::KeyedMutex cache_mutex;
+        std::unique_ptr<util::KeyedMutex::Lock> lock;
+
         auto j = trans_cache.find(key);
+        if (j == trans_cache.end() && creator.supported()) {
+            lock = std::make_unique<util::KeyedMutex::Lock>(cache_mutex, key);
+            j    = trans_cache.find(key);
+        }
+
         if (j != trans_cache.end()) {
 
             ASSERT(j->transCache_);
-            trans = atlas_trans_t(j->transCache_, grid, domain, truncation, options_);
+            transCache = j->transCache_;
         }
         else if (!creator.supported()) {
 
             Log::warning() << "ShToGridded: LegendreCacheCreator is not supported for:"
                            << "\n  representation: " << representation << "\n  options: " << options_ << std::endl
                            << "ShToGridded: continuing with hindered performance" << std::endl;
-
-            trans = atlas_trans_t(grid, domain, truncation, options_);
         }
         else if (!caching) {
 
-            auto& entry(trans_cache[key] = creator.create());
-            ASSERT(entry.transCache_);
-            trans = atlas_trans_t(entry.transCache_, grid, domain, truncation, options_);
+            std::unique_ptr<TransCache> entry(new TransCache);
+            {
+                util::lock_guard<util::recursive_mutex> guard(trans_mutex);
+                util::parallel_omp_num_threads(parametrisation());
+                *entry = creator.create();
+            }
+            ASSERT(entry->transCache_);
+
+            transCache = trans_cache.insert(key, entry.release()).transCache_;
         }
         else {
 
             ASSERT(creator.supported());
-            atlas::trans::Cache transCache = getTransCache(creator, key, parametrisation(), ctx);
+            transCache = getTransCache(creator, key, parametrisation(), ctx);
             ASSERT(transCache);
-            trans = atlas_trans_t(transCache, grid, domain, truncation, options_);
         }
     }
     catch (std::exception& e) {
+        // entries are inserted complete, so there is no incomplete entry to remove
         Log::error() << "ShToGridded::caching: " << e.what() << std::endl;
-        trans_cache.erase(key);
         throw;
     }
-    ASSERT(trans);
 
     try {
+        // transforms are created, executed and destroyed one at a time (in reverse order of declaration)
+        util::lock_guard<util::recursive_mutex> guard(trans_mutex);
+
+        atlas_trans_t trans = transCache ? atlas_trans_t(transCache, grid, domain, truncation, options_)
+                                         : atlas_trans_t(grid, domain, truncation, options_);
+        ASSERT(trans);
 
         auto time(ctx.statistics().sh2gridTimer());
         sh2grid(field, trans, parametrisation());
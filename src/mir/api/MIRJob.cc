@@ -19,6 +19,7 @@
 #include "eckit/utils/Tokenizer.h"
 
 #include "mir/action/plan/Job.h"
+#include "mir/action/plan/PlanCache.h"
 #include "mir/data/MIRField.h"
 #include "mir/input/MIRInput.h"
 #include "mir/repres/Representation.h"
@@ -30,7 +31,7 @@
 namespace mir::api {
 
 
-MIRJob::MIRJob() = default;
+MIRJob::MIRJob() : planCache_(new action::PlanCache) {}
 
 
 MIRJob::~MIRJob() = default;
@@ -41,6 +42,15 @@ void MIRJob::execute(input::MIRInput& input, output::MIROutput& output, util::MI
     bool dont_compress = false;
     get("dont-compress-plan", dont_compress);
 
+    // reuse action plans across fields (the same job applied to fields of identical relevant metadata)
+    bool planCache = true;
+    get("plan-cache", planCache);
+
+    if (planCache) {
+        action::Job(*this, input, output, !dont_compress, *planCache_).execute(statistics);
+        return;
+    }
+
     action::Job(*this, input, output, !dont_compress).execute(statistics);
 }
 
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "eckit/config/Configured.h"
@@ -20,6 +21,9 @@
 
 
 namespace mir {
+namespace action {
+class PlanCache;
+}
 namespace input {
 class MIRInput;
 }
@@ -119,7 +123,8 @@ protected:
 
 private:
     // -- Members
-    // None
+
+    std::unique_ptr<action::PlanCache> planCache_;
 
     // -- Methods
 
@@ -15,6 +15,7 @@
 #include "eckit/container/CacheManager.h"
 
 #include "mir/caching/AreaCacheEntry.h"
+#include "mir/caching/CacheManagerFileLease.h"
 
 
 namespace mir::caching {
@@ -23,7 +24,7 @@ namespace mir::caching {
 struct AreaMaskerCacheTraits {
 
     using value_type = AreaCacheEntry;
-    using Locker     = eckit::CacheManagerFileFlock;
+    using Locker     = CacheManagerFileLease;
 
     static const char* name();
     static int version();
@@ -0,0 +1,233 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/caching/CacheManagerFileLease.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+
+#include "eckit/config/Resource.h"
+#include "eckit/os/AutoUmask.h"
+#include "eckit/runtime/Main.h"
+
+#include "mir/util/Exceptions.h"
+#include "mir/util/Log.h"
+
+
+namespace mir::caching {
+
+
+namespace {
+
+
+double lease_stale() {
+    static const double stale = eckit::Resource<double>("$MIR_CACHE_LEASE_STALE", 300.);
+    return stale;
+}
+
+
+double lease_timeout() {
+    static const double timeout = eckit::Resource<double>("$MIR_CACHE_LEASE_TIMEOUT", 3600.);
+    return timeout;
+}
+
+
+std::string unique_owner() {
+    // host and process (see stale), and a lease number (several leases can be held by threads of a process)
+    static std::atomic<size_t> next{0};
+    return eckit::Main::hostname() + " " + std::to_string(::getpid()) + " " + std::to_string(next++);
+}
+
+
+}  // namespace
+
+
+CacheManagerFileLease::CacheManagerFileLease(const std::string& path) :
+    path_(path + ".lease"),
+    owner_(unique_owner()),
+    locked_(false),
+    stopping_(false) {}
+
+
+CacheManagerFileLease::~CacheManagerFileLease() {
+    if (locked_) {
+        unlock();
+    }
+}
+
+
+bool CacheManagerFileLease::acquire() {
+    eckit::AutoUmask umask(0);
+
+    auto fd = ::open(path_.localPath(), O_CREAT | O_EXCL | O_WRONLY, 0666);
+    if (fd < 0) {
+        if (errno == EEXIST) {
+            return false;
+        }
+        throw exception::FailedSystemCall("open('" + path_.asString() + "', O_CREAT | O_EXCL)");
+    }
+
+    const auto line = owner_ + "\n";
+    auto len        = ::write(fd, line.c_str(), line.size());
+    ::close(fd);
+
+    if (len != static_cast<decltype(len)>(line.size())) {
+        path_.unlink(false);
+        throw exception::WriteError("CacheManagerFileLease: cannot write '" + path_.asString() + "'");
+    }
+
+    return true;
+}
+
+
+bool CacheManagerFileLease::stale(double age) const {
+    if (age > lease_stale()) {
+        return true;
+    }
+
+    // lease holder process is gone (on the same host)
+    std::ifstream in(path_.localPath());
+    std::string host;
+    pid_t pid = 0;
+
+    return in >> host >> pid && host == eckit::Main::hostname() && ::kill(pid, 0) != 0 && errno == ESRCH;
+}
+
+
+bool CacheManagerFileLease::takeOver(const struct stat& seen) const {
+    // claim the lease by a hard link to it (only one waiter succeeds), and check through the claim (the same file) it
+    // is the stale lease; it is then rewritten in place as ours (so a previous holder still running sees it lost it,
+    // see unlock), and kept if it is still the lease. The lease file is never moved, nor removed by a waiter
+    const eckit::PathName claim(path_ + ".takeover");
+
+    if (::link(path_.localPath(), claim.localPath()) != 0) {
+        // claim left by a waiter that did not finish (creating a link changes the file status time)
+        struct stat c {};
+        if (errno == EEXIST && ::stat(claim.localPath(), &c) == 0 &&
+            std::difftime(std::time(nullptr), c.st_ctime) > lease_stale()) {
+            Log::warning() << "CacheManagerFileLease: removing stale claim '" << claim << "'" << std::endl;
+            claim.unlink(false);
+        }
+        return false;
+    }
+
+    struct stat s {};
+    bool ours = ::stat(claim.localPath(), &s) == 0 && s.st_dev == seen.st_dev && s.st_ino == seen.st_ino &&
+                s.st_mtime == seen.st_mtime;
+
+    if (ours) {
+        {
+            std::ofstream out(claim.localPath(), std::ios::trunc);
+            out << owner_ << std::endl;
+            ours = bool(out);
+        }
+        ::utime(claim.localPath(), nullptr);
+
+        struct stat p {};
+        ours = ours && ::stat(path_.localPath(), &p) == 0 && p.st_dev == s.st_dev && p.st_ino == s.st_ino;
+    }
+
+    claim.unlink(false);
+    return ours;
+}
+
+
+bool CacheManagerFileLease::owned() const {
+    std::ifstream in(path_.localPath());
+    std::string line;
+    return std::getline(in, line) && line == owner_;
+}
+
+
+void CacheManagerFileLease::lock() {
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+
+    path_.dirName().mkdir();
+
+    bool waiting = false;
+    for (bool acquired = acquire(); !acquired; acquired = acquire()) {
+        if (!waiting) {
+            Log::info() << "CacheManagerFileLease: waiting for '" << path_ << "'" << std::endl;
+            waiting = true;
+        }
+
+        struct stat s {};
+        if (::stat(path_.localPath(), &s) != 0) {
+            continue;  // released in the meantime
+        }
+
+        if (auto age = std::difftime(std::time(nullptr), s.st_mtime); stale(age)) {
+            if (takeOver(s)) {
+                Log::warning() << "CacheManagerFileLease: taken over stale lease '" << path_ << "'" << std::endl;
+                break;
+            }
+            continue;
+        }
+
+        if (std::chrono::duration<double>(clock::now() - start).count() > lease_timeout()) {
+            Log::warning() << "CacheManagerFileLease: timeout waiting for '" << path_ << "', continuing without lease"
+                           << std::endl;
+            return;
+        }
+
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+
+    locked_   = true;
+    stopping_ = false;
+
+    // keep the lease fresh while creating the cache entry
+    heartbeat_ = std::thread([this]() {
+        const auto period = std::chrono::duration<double>(lease_stale() / 4.);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_.wait_for(lock, period, [this]() { return stopping_; })) {
+            ::utime(path_.localPath(), nullptr);
+        }
+    });
+}
+
+
+void CacheManagerFileLease::unlock() {
+    if (!locked_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    stop_.notify_all();
+    heartbeat_.join();
+
+    // the lease could have been taken over (not refreshed in time), then it is not ours to remove
+    if (owned()) {
+        path_.unlink(false);
+    }
+    else {
+        Log::warning() << "CacheManagerFileLease: lease '" << path_ << "' was taken over" << std::endl;
+    }
+    locked_ = false;
+}
+
+
+}  // namespace mir::caching
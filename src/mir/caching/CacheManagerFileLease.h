@@ -0,0 +1,82 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <sys/stat.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "eckit/filesystem/PathName.h"
+
+
+namespace mir::caching {
+
+
+/**
+ * Cache creation lock (eckit::CacheManager Locker) across processes and hosts sharing the cache directory: a lease
+ * file is created exclusively by the process creating the cache entry, and kept fresh while it holds it; other
+ * processes wait for its release, and then load the created entry.
+ *
+ * A lease is taken over if stale (not refreshed for $MIR_CACHE_LEASE_STALE seconds, or its process is gone on the
+ * same host), by one waiter claiming it exclusively and rewriting it in place; after waiting for
+ * $MIR_CACHE_LEASE_TIMEOUT seconds, the process continues without the lease (creating the entry independently, as the
+ * cache commit is atomic).
+ */
+class CacheManagerFileLease {
+public:
+    // -- Constructors
+
+    explicit CacheManagerFileLease(const std::string& path);
+
+    CacheManagerFileLease(const CacheManagerFileLease&) = delete;
+    CacheManagerFileLease(CacheManagerFileLease&&)      = delete;
+
+    // -- Destructor
+
+    ~CacheManagerFileLease();
+
+    // -- Operators
+
+    void operator=(const CacheManagerFileLease&) = delete;
+    void operator=(CacheManagerFileLease&&)      = delete;
+
+    // -- Methods
+
+    void lock();
+    void unlock();
+
+private:
+    // -- Members
+
+    const eckit::PathName path_;
+    const std::string owner_;
+    bool locked_;
+
+    std::thread heartbeat_;
+    std::mutex mutex_;
+    std::condition_variable stop_;
+    bool stopping_;
+
+    // -- Methods
+
+    bool acquire();
+    bool stale(double age) const;
+    bool takeOver(const struct stat&) const;
+    bool owned() const;
+};
+
+
+}  // namespace mir::caching
@@ -118,6 +118,7 @@ void InMemoryCache<T>::reserve(const InMemoryCacheUsage& usage) {
                  << std::endl;
 
 
+    // forced (entries in use by other threads are pinned)
     if (p) {
         purge(p, true);
     }
@@ -228,6 +229,25 @@ void InMemoryCache<T>::stopUsing(InMemoryCacheStatistics& statistics) {
 }
 
 
+template <class T>
+void InMemoryCache<T>::pin(const std::string& key) {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
+    pinned_[key]++;
+}
+
+
+template <class T>
+void InMemoryCache<T>::unpin(const std::string& key) {
+    util::lock_guard<util::recursive_mutex> lock(mutex_);
+
+    auto j = pinned_.find(key);
+    ASSERT(j != pinned_.end() && j->second > 0);
+    if (--(j->second) == 0) {
+        pinned_.erase(j);
+    }
+}
+
+
 template <class T>
 void InMemoryCache<T>::erase(const std::string& key) {
     util::lock_guard<util::recursive_mutex> lock(mutex_);
@@ -268,17 +288,27 @@ InMemoryCacheUsage InMemoryCache<T>::purge(const InMemoryCacheUsage& amount, boo
         }
 
         double now = utime();
-        auto best  = cache_.begin();
+        auto best  = cache_.end();
         double m   = 0;
 
         for (auto j = cache_.begin(); j != cache_.end(); ++j) {
+            if (pinned_.find(j->first) != pinned_.end()) {
+                continue;
+            }
+
             double s = score(j->second->hits_, now - j->second->last_, now - j->second->insert_);
-            if (s > m) {
+            if (best == cache_.end() || s > m) {
                 m    = s;
                 best = j;
             }
         }
 
+        if (best == cache_.end()) {
+            Log::debug() << "CACHE " << name_ << " purging " << amount << ", remaining entries are pinned"
+                         << std::endl;
+            break;
+        }
+
         if (m < statistics_.youngest_ || statistics_.youngest_ == 0) {
             statistics_.youngest_ = m;
         }
@@ -53,6 +53,9 @@ public:  // methods
     void startUsing();
     void stopUsing(InMemoryCacheStatistics&);
 
+    void pin(const std::string& key);
+    void unpin(const std::string& key);
+
 private:
     void purge();
     T& create(const std::string& key);
@@ -66,6 +69,7 @@ private:
     size_t users_;
     mutable InMemoryCacheStatistics statistics_;
     mutable std::map<std::string, InMemoryCacheUsage> keys_;
+    std::map<std::string, size_t> pinned_;
     mutable util::recursive_mutex mutex_;
 
     struct Entry {
@@ -107,6 +111,24 @@ public:
     void operator=(InMemoryCacheUser&&)      = delete;
 };
 
+template <class T>
+class InMemoryCachePin {
+    InMemoryCache<T>& cache_;
+    const std::string key_;
+
+public:
+    /// Entry with this key (existing or inserted later) is not purged while pinned, even if purging is forced
+    InMemoryCachePin(InMemoryCache<T>& cache, const std::string& key) : cache_(cache), key_(key) { cache_.pin(key_); }
+
+    InMemoryCachePin(const InMemoryCachePin&) = delete;
+    InMemoryCachePin(InMemoryCachePin&&)      = delete;
+
+    ~InMemoryCachePin() { cache_.unpin(key_); }
+
+    void operator=(const InMemoryCachePin&) = delete;
+    void operator=(InMemoryCachePin&&)      = delete;
+};
+
 
 }  // namespace caching
 }  // namespace mir
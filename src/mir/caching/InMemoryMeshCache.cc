@@ -18,10 +18,10 @@
 
 #include "mir/method/fe/CalculateCellLongestDiagonal.h"
 #include "mir/util/Exceptions.h"
+#include "mir/util/KeyedMutex.h"
 #include "mir/util/Log.h"
 #include "mir/util/MIRStatistics.h"
 #include "mir/util/MeshGeneratorParameters.h"
-#include "mir/util/Mutex.h"
 #include "mir/util/Trace.h"
 #include "mir/util/Types.h"
 
@@ -29,7 +29,7 @@
 namespace mir::caching {
 
 
-static util::recursive_mutex local_mutex;
+static util::KeyedMutex local_mutex;
 
 constexpr size_t CAPACITY = 512 * 1024 * 1024;
 static InMemoryCache<atlas::Mesh> mesh_cache("mirMesh", CAPACITY, 0, "$MIR_MESH_CACHE_MEMORY_FOOTPRINT");
@@ -43,8 +43,6 @@ const InMemoryMeshCache& InMemoryMeshCache::instance() {
 
 atlas::Mesh InMemoryMeshCache::atlasMesh(util::MIRStatistics& statistics, const atlas::Grid& grid,
                                          const util::MeshGeneratorParameters& meshGeneratorParams) {
-    util::lock_guard<util::recursive_mutex> guard(local_mutex);
-
     auto& log = Log::debug();
     trace::ResourceUsage usage_mesh("Mesh for grid " + grid.name() + " (" + grid.uid() + ")");
     auto cacheUse(statistics.cacheUser(mesh_cache));
@@ -55,77 +53,76 @@ atlas::Mesh InMemoryMeshCache::atlasMesh(util::MIRStatistics& statistics, const
     md5 << meshGeneratorParams;
 
     auto sign(md5.digest());
-    auto j = mesh_cache.find(sign);
-    if (j != mesh_cache.end()) {
+    if (auto j = mesh_cache.find(sign); j != mesh_cache.end()) {
+        return *j;
+    }
+
+    // single-flight: threads requiring the same mesh wait for the first one to generate it, others are not blocked
+    util::KeyedMutex::Lock lock(local_mutex, sign);
+
+    if (auto j = mesh_cache.find(sign); j != mesh_cache.end()) {
         return *j;
     }
 
-    atlas::Mesh& mesh = mesh_cache[sign];
-    ASSERT(!mesh.generated());
-
-    try {
-        log << "InMemoryMeshCache: generating mesh using " << meshGeneratorParams << std::endl;
-
-        atlas::MeshGenerator generator(meshGeneratorParams.meshGenerator_, meshGeneratorParams);
-        mesh = generator.generate(grid);
-        ASSERT(mesh.generated());
-
-        // If meshgenerator did not create xyz field already, do it now.
-        {
-            trace::ResourceUsage timer("Mesh: BuildXYZField");
-            atlas::mesh::actions::BuildXYZField()(mesh);
-        }
-
-        // Calculate barycenters of mesh cells
-        if (meshGeneratorParams.meshCellCentres_) {
-            trace::ResourceUsage timer("Mesh: BuildCellCentres");
-            atlas::mesh::actions::BuildCellCentres()(mesh);
-        }
-
-        // Calculate the mesh cells longest diagonal
-        if (meshGeneratorParams.meshCellLongestDiagonal_) {
-            trace::ResourceUsage usage("CalculateCellLongestDiagonal");
-            method::fe::CalculateCellLongestDiagonal()(mesh, grid.domain().global());
-        }
-
-        // Calculate node-to-cell ("inverse") connectivity
-        if (meshGeneratorParams.meshNodeToCellConnectivity_) {
-            trace::ResourceUsage timer("Mesh: BuildNode2CellConnectivity");
-            atlas::mesh::actions::BuildNode2CellConnectivity{mesh}();
-        }
-
-        // Some information
-        log << "Mesh[cells=" << Log::Pretty(mesh.cells().size()) << ",nodes=" << Log::Pretty(mesh.nodes().size()) << ","
-            << meshGeneratorParams << "]" << std::endl;
-
-        // Write file(s)
-        if (!meshGeneratorParams.fileLonLat_.empty()) {
-            atlas::output::PathName path(meshGeneratorParams.fileLonLat_);
-            log << "Mesh: writing lonlat to '" << path << "'" << std::endl;
-            atlas::output::Gmsh(path, atlas::util::Config("coordinates", "lonlat")("ghost", true)).write(mesh);
-        }
-
-        if (!meshGeneratorParams.fileXY_.empty()) {
-            atlas::output::PathName path(meshGeneratorParams.fileXY_);
-            log << "Mesh: writing xy to '" << path << "'" << std::endl;
-            atlas::output::Gmsh(path, atlas::util::Config("coordinates", "xy")("ghost", true)).write(mesh);
-        }
-
-        if (!meshGeneratorParams.fileXYZ_.empty()) {
-            atlas::output::PathName path(meshGeneratorParams.fileXYZ_);
-            log << "Mesh: writing xyz to '" << path << "'" << std::endl;
-            atlas::output::Gmsh(path, atlas::util::Config("coordinates", "xyz")("ghost", true)).write(mesh);
-        }
+    log << "InMemoryMeshCache: generating mesh using " << meshGeneratorParams << std::endl;
+
+    atlas::MeshGenerator generator(meshGeneratorParams.meshGenerator_, meshGeneratorParams);
+    atlas::Mesh mesh = generator.generate(grid);
+    ASSERT(mesh.generated());
+
+    // If meshgenerator did not create xyz field already, do it now.
+    {
+        trace::ResourceUsage timer("Mesh: BuildXYZField");
+        atlas::mesh::actions::BuildXYZField()(mesh);
     }
-    catch (...) {
-        // Make sure we don't leave an incomplete entry in the cache
-        mesh_cache.erase(sign);
-        throw;
+
+    // Calculate barycenters of mesh cells
+    if (meshGeneratorParams.meshCellCentres_) {
+        trace::ResourceUsage timer("Mesh: BuildCellCentres");
+        atlas::mesh::actions::BuildCellCentres()(mesh);
     }
 
-    mesh_cache.footprint(sign, InMemoryCacheUsage(mesh.footprint(), 0));
+    // Calculate the mesh cells longest diagonal
+    if (meshGeneratorParams.meshCellLongestDiagonal_) {
+        trace::ResourceUsage usage("CalculateCellLongestDiagonal");
+        method::fe::CalculateCellLongestDiagonal()(mesh, grid.domain().global());
+    }
 
+    // Calculate node-to-cell ("inverse") connectivity
+    if (meshGeneratorParams.meshNodeToCellConnectivity_) {
+        trace::ResourceUsage timer("Mesh: BuildNode2CellConnectivity");
+        atlas::mesh::actions::BuildNode2CellConnectivity{mesh}();
+    }
+
+    // Some information
+    log << "Mesh[cells=" << Log::Pretty(mesh.cells().size()) << ",nodes=" << Log::Pretty(mesh.nodes().size()) << ","
+        << meshGeneratorParams << "]" << std::endl;
+
+    // Write file(s)
+    if (!meshGeneratorParams.fileLonLat_.empty()) {
+        atlas::output::PathName path(meshGeneratorParams.fileLonLat_);
+        log << "Mesh: writing lonlat to '" << path << "'" << std::endl;
+        atlas::output::Gmsh(path, atlas::util::Config("coordinates", "lonlat")("ghost", true)).write(mesh);
+    }
+
+    if (!meshGeneratorParams.fileXY_.empty()) {
+        atlas::output::PathName path(meshGeneratorParams.fileXY_);
+        log << "Mesh: writing xy to '" << path << "'" << std::endl;
+        atlas::output::Gmsh(path, atlas::util::Config("coordinates", "xy")("ghost", true)).write(mesh);
+    }
+
+    if (!meshGeneratorParams.fileXYZ_.empty()) {
+        atlas::output::PathName path(meshGeneratorParams.fileXYZ_);
+        log << "Mesh: writing xyz to '" << path << "'" << std::endl;
+        atlas::output::Gmsh(path, atlas::util::Config("coordinates", "xyz")("ghost", true)).write(mesh);
+    }
+
+    // insert complete mesh, as it is visible to other threads
     ASSERT(mesh.generated());
+
+    mesh_cache.insert(sign, new atlas::Mesh(mesh));
+    mesh_cache.footprint(sign, InMemoryCacheUsage(mesh.footprint(), 0));
+
     return mesh;
 }
 
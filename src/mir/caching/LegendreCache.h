@@ -14,6 +14,8 @@
 
 #include "eckit/container/CacheManager.h"
 
+#include "mir/caching/CacheManagerFileLease.h"
+
 
 namespace mir::caching {
 
@@ -21,7 +23,7 @@ namespace mir::caching {
 struct LegendreCacheTraits {
 
     using value_type = int;  // dummy
-    using Locker     = eckit::CacheManagerFileFlock;
+    using Locker     = CacheManagerFileLease;
 
     static const char* name();
     static int version();
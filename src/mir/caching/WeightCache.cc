@@ -19,6 +19,7 @@
 #include "mir/caching/matrix/MatrixLoader.h"
 #include "mir/config/LibMir.h"
 #include "mir/method/WeightMatrix.h"
+#include "mir/method/WeightMatrixSinglePrecision.h"
 #include "mir/param/MIRParametrisation.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
@@ -87,5 +88,40 @@ void WeightCacheTraits::load(const eckit::CacheManagerBase& manager, value_type&
 }
 
 
+WeightCacheSinglePrecision::WeightCacheSinglePrecision() :
+    eckit::CacheManager<WeightCacheSinglePrecisionTraits>(
+        "file-io",  // dummy -- would be used in load() / save() static functions
+        LibMir::cacheDir(), eckit::Resource<bool>("$MIR_THROW_ON_CACHE_MISS;mirThrowOnCacheMiss", false),
+        eckit::Resource<size_t>("$MIR_MATRIX_CACHE_SIZE", 0)) {}
+
+
+const char* WeightCacheSinglePrecisionTraits::name() {
+    return WeightCacheTraits::name();
+}
+
+
+int WeightCacheSinglePrecisionTraits::version() {
+    return WeightCacheTraits::version();
+}
+
+
+const char* WeightCacheSinglePrecisionTraits::extension() {
+    return ".mat32";
+}
+
+
+void WeightCacheSinglePrecisionTraits::save(const eckit::CacheManagerBase& /*unused*/, const value_type& W,
+                                            const eckit::PathName& path) {
+    Log::debug() << "Inserting weights (single precision) in cache : " << path << "" << std::endl;
+    W.save(path);
+}
+
+
+void WeightCacheSinglePrecisionTraits::load(const eckit::CacheManagerBase& /*unused*/, value_type& W,
+                                            const eckit::PathName& path) {
+    W.load(path);
+}
+
+
 }  // namespace caching
 }  // namespace mir
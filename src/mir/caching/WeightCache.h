@@ -14,10 +14,13 @@
 
 #include "eckit/container/CacheManager.h"
 
+#include "mir/caching/CacheManagerFileLease.h"
+
 
 namespace mir {
 namespace method {
 class WeightMatrix;
+class WeightMatrixSinglePrecision;
 }
 namespace param {
 class MIRParametrisation;
@@ -31,7 +34,7 @@ namespace mir::caching {
 struct WeightCacheTraits {
 
     using value_type = method::WeightMatrix;
-    using Locker     = eckit::CacheManagerFileFlock;
+    using Locker     = CacheManagerFileLease;
 
     static const char* name();
     static int version();
@@ -53,4 +56,24 @@ private:  // members
 };
 
 
+struct WeightCacheSinglePrecisionTraits {
+
+    using value_type = method::WeightMatrixSinglePrecision;
+    using Locker     = CacheManagerFileLease;
+
+    static const char* name();
+    static int version();
+    static const char* extension();
+
+    static void save(const eckit::CacheManagerBase&, const value_type&, const eckit::PathName&);
+    static void load(const eckit::CacheManagerBase&, value_type&, const eckit::PathName&);
+};
+
+
+class WeightCacheSinglePrecision : public eckit::CacheManager<WeightCacheSinglePrecisionTraits> {
+public:  // methods
+    explicit WeightCacheSinglePrecision();
+};
+
+
 }  // namespace mir::caching
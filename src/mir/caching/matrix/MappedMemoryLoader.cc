@@ -0,0 +1,151 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/caching/matrix/MappedMemoryLoader.h"
+
+#include <cstring>
+#include <memory>
+#include <ostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "eckit/io/AutoCloser.h"
+#include "eckit/io/DataHandle.h"
+#include "eckit/memory/MMap.h"
+#include "eckit/memory/MemoryBuffer.h"
+#include "eckit/os/Stat.h"
+
+#include "mir/method/WeightMatrix.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Log.h"
+#include "mir/util/Trace.h"
+#include "mir/util/Types.h"
+
+
+namespace mir::caching::matrix {
+
+
+MappedMemoryLoader::MappedMemoryLoader(const std::string& name, const eckit::PathName& path) :
+    MatrixLoader(name, path), image_(imagePath(path_)), buffer_(0), fd_(-1), address_(nullptr), size_(0) {
+    trace::Timer timer("MappedMemoryLoader: mapping '" + path.asString() + "'");
+
+    ASSERT(sizeof(size_) > 4);
+
+    // (re-)create the memory image if missing or older than the matrix
+    if (!image_.exists() || image_.lastModified() < path_.lastModified()) {
+        if (::access(image_.dirName().localPath(), W_OK) != 0) {
+            // read-only cache: load privately, as the "file-io" loader does
+            Log::warning() << "MappedMemoryLoader: cannot create '" << image_ << "', loading '" << path_
+                           << "' into memory" << std::endl;
+
+            method::WeightMatrix w(path_);
+            buffer_.resize(w.footprint());
+            w.dump(buffer_);
+            return;
+        }
+
+        createImage(path_, image_);
+    }
+
+    fd_ = ::open(image_.localPath(), O_RDONLY);
+    if (fd_ < 0) {
+        Log::error() << "open(" << image_ << ')' << Log::syserr << std::endl;
+        throw exception::FailedSystemCall("open");
+    }
+
+    eckit::Stat::Struct s;
+    SYSCALL(eckit::Stat::stat(image_.localPath(), &s));
+
+    ASSERT(s.st_size > 0);
+    size_ = size_t(s.st_size);
+
+    address_ = eckit::MMap::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (address_ == MAP_FAILED) {
+        address_ = nullptr;
+        Log::error() << "mmap(" << image_ << ',' << size_ << ')' << Log::syserr << std::endl;
+        throw exception::FailedSystemCall("mmap");
+    }
+}
+
+
+MappedMemoryLoader::~MappedMemoryLoader() {
+    if (address_ != nullptr) {
+        SYSCALL(eckit::MMap::munmap(address_, size_));
+    }
+    if (fd_ >= 0) {
+        SYSCALL(::close(fd_));
+    }
+}
+
+
+eckit::PathName MappedMemoryLoader::imagePath(const eckit::PathName& path) {
+    return path + ".mmap";
+}
+
+
+void MappedMemoryLoader::createImage(const eckit::PathName& path, const eckit::PathName& image) {
+    trace::Timer timer("MappedMemoryLoader: creating '" + image.asString() + "'");
+
+    method::WeightMatrix w(path);
+    eckit::MemoryBuffer buffer(w.footprint());
+    std::memset(buffer.data(), 0, buffer.size());
+    w.dump(buffer);
+
+    // write to a unique file, then rename (atomic) so concurrent readers only ever see a complete image
+    auto tmp = eckit::PathName::unique(image);
+    {
+        std::unique_ptr<eckit::DataHandle> h(tmp.fileHandle());
+        h->openForWrite(0);
+        auto c = eckit::closer(*h);
+        ASSERT(h->write(buffer, long(buffer.size())) == long(buffer.size()));
+    }
+
+    eckit::PathName::rename(tmp, image);
+}
+
+
+void MappedMemoryLoader::print(std::ostream& out) const {
+    out << "MappedMemoryLoader[path=" << path_;
+    if (address_ != nullptr) {
+        out << ",image=" << image_;
+    }
+    out << ",size=" << Log::Bytes(size()) << "]";
+}
+
+
+const void* MappedMemoryLoader::address() const {
+    return address_ != nullptr ? address_ : static_cast<const void*>(buffer_);
+}
+
+
+size_t MappedMemoryLoader::size() const {
+    return address_ != nullptr ? size_ : buffer_.size();
+}
+
+
+bool MappedMemoryLoader::inSharedMemory() const {
+    return address_ != nullptr;
+}
+
+
+bool MappedMemoryLoader::shared() {
+    return true;
+}
+
+
+static const MatrixLoaderBuilder<MappedMemoryLoader> loader1("mapped-memory");
+static const MatrixLoaderBuilder<MappedMemoryLoader> loader2("mmap");
+
+
+}  // namespace mir::caching::matrix
@@ -0,0 +1,55 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include "eckit/memory/MemoryBuffer.h"
+
+#include "mir/caching/matrix/MatrixLoader.h"
+
+
+namespace mir::caching::matrix {
+
+
+/**
+ * Map (read-only) a memory image of the matrix, shared by all processes through the page cache. The image is created
+ * next to the cached matrix (with extension ".mmap") on first use, written to a unique path then renamed atomically.
+ * If the cache is read-only and there is no up-to-date image, the matrix is loaded into private memory instead.
+ */
+class MappedMemoryLoader : public MatrixLoader {
+public:
+    MappedMemoryLoader(const std::string& name, const eckit::PathName&);
+
+    ~MappedMemoryLoader() override;
+
+    static bool shared();
+
+    static eckit::PathName imagePath(const eckit::PathName&);
+    static void createImage(const eckit::PathName& path, const eckit::PathName& image);
+
+protected:
+    void print(std::ostream&) const override;
+
+private:
+    const void* address() const override;
+    size_t size() const override;
+    bool inSharedMemory() const override;
+
+    eckit::PathName image_;
+    eckit::MemoryBuffer buffer_;
+    int fd_;
+    void* address_;
+    size_t size_;
+};
+
+
+}  // namespace mir::caching::matrix
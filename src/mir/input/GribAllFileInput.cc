@@ -14,41 +14,19 @@
 
 #include <ostream>
 
-#include "eckit/io/Buffer.h"
-#include "eckit/io/StdFile.h"
-
 #include "mir/data/MIRField.h"
+#include "mir/input/GribFileIndex.h"
 #include "mir/input/GribFileInput.h"
 #include "mir/util/Exceptions.h"
-#include "mir/util/Grib.h"
 
 
 namespace mir::input {
 
 
 GribAllFileInput::GribAllFileInput(const std::string& path) : path_(path), count_(0) {
-
-    eckit::AutoStdFile f(path);
-    eckit::Buffer buffer(64 * 1024 * 1024);
-
-    for (;;) {
-        size_t len = buffer.size();
-        off_t here;
-        SYSCALL(here = ::ftello(f));
-        int e = wmo_read_any_from_file(f, buffer, &len);
-        if (e == CODES_END_OF_FILE) {
-            break;
-        }
-
-        if (e == CODES_BUFFER_TOO_SMALL) {
-            GRIB_ERROR(e, "wmo_read_any_from_file");
-        }
-
-        if (e != CODES_SUCCESS) {
-            GRIB_ERROR(e, "wmo_read_any_from_file");
-        }
-
-        inputs_.push_back(new GribFileInput(path, here));
+    GribFileIndex index(path);
+    for (const auto& entry : index.entries()) {
+        inputs_.push_back(new GribFileInput(path, entry.offset));
     }
 }
 
@@ -32,6 +32,7 @@ GribDataHandleInput::GribDataHandleInput(eckit::DataHandle& handle) : handle_(ha
 }
 
 GribDataHandleInput::~GribDataHandleInput() {
+    stop();
     handle_.close();
 }
 
@@ -0,0 +1,383 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/input/GribFileIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+
+#include "eckit/config/Resource.h"
+#include "eckit/io/StdFile.h"
+#include "eckit/utils/MD5.h"
+#include "eckit/utils/Tokenizer.h"
+
+#include "mir/config/LibMir.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Grib.h"
+#include "mir/util/Log.h"
+#include "mir/util/Trace.h"
+
+
+namespace mir::input {
+
+
+namespace {
+
+
+const std::string MAGIC = "MIRGRIBINDEX\t1";
+
+
+const std::string& index_mode() {
+    static const std::string mode = eckit::Resource<std::string>("$MIR_GRIB_INDEX", "memory");
+    ASSERT_MSG(mode == "memory" || mode == "file" || mode == "cache" || mode == "off",
+               "GribFileIndex: MIR_GRIB_INDEX should be one of memory, file, cache or off");
+    return mode;
+}
+
+
+std::vector<std::string> index_keys() {
+    static const std::string keys =
+        eckit::Resource<std::string>("$MIR_GRIB_INDEX_KEYS", "paramId,levtype,level,step,gridType");
+
+    std::vector<std::string> v;
+    eckit::Tokenizer(",")(keys, v);
+    return v;
+}
+
+
+std::string join(const std::vector<std::string>& v) {
+    std::string line;
+    const auto* sep = "";
+    for (const auto& token : v) {
+        line += sep + token;
+        sep = "\t";
+    }
+    return line;
+}
+
+
+std::vector<std::string> split(const std::string& line) {
+    // keeps empty tokens (keys not defined in a message)
+    std::vector<std::string> v;
+    for (size_t start = 0;;) {
+        auto end = line.find('\t', start);
+        v.emplace_back(line.substr(start, end == std::string::npos ? end : end - start));
+        if (end == std::string::npos) {
+            return v;
+        }
+        start = end + 1;
+    }
+}
+
+
+}  // namespace
+
+
+GribFileIndex::GribFileIndex(const eckit::PathName& path) :
+    path_(path), size_(path.size()), modified_(path.lastModified()), keys_(index_keys()) {
+    const auto& mode = index_mode();
+
+    eckit::PathName persist;
+    if (mode == "file") {
+        persist = path_ + ".mirindex";
+    }
+    else if (mode == "cache") {
+        persist = eckit::PathName(LibMir::cacheDir()) / "mir/grib-index" /
+                  (eckit::MD5(path_.realName().asString()).digest() + ".mirindex");
+    }
+
+    if (!persist.asString().empty() && persist.exists()) {
+        try {
+            if (load(persist)) {
+                Log::debug() << "GribFileIndex: loaded " << *this << " from " << persist << std::endl;
+                return;
+            }
+        }
+        catch (std::exception& e) {
+            Log::warning() << "GribFileIndex: could not load index from " << persist << ": " << e.what() << std::endl;
+        }
+    }
+
+    build();
+
+    if (!persist.asString().empty()) {
+        try {
+            save(persist);
+        }
+        catch (std::exception& e) {
+            Log::warning() << "GribFileIndex: could not save index to " << persist << ": " << e.what() << std::endl;
+        }
+    }
+}
+
+
+GribFileIndex::~GribFileIndex() = default;
+
+
+bool GribFileIndex::indexed(const std::string& key) const {
+    return std::find(keys_.begin(), keys_.end(), key) != keys_.end();
+}
+
+
+size_t GribFileIndex::find(size_t from, const std::string& key, const std::string& value) const {
+    auto k = std::find(keys_.begin(), keys_.end(), key);
+    ASSERT_MSG(k != keys_.end(), "GribFileIndex: key '" + key + "' is not indexed");
+
+    const auto which = static_cast<size_t>(k - keys_.begin());
+    for (auto i = from; i < entries_.size(); ++i) {
+        if (entries_[i].values[which] == value) {
+            return i;
+        }
+    }
+
+    return entries_.size();
+}
+
+
+bool GribFileIndex::enabled() {
+    return index_mode() != "off";
+}
+
+
+void GribFileIndex::build() {
+    trace::Timer timer("GribFileIndex: build index of " + path_.asString());
+
+    eckit::AutoStdFile f(path_);
+    std::vector<unsigned char> buffer;
+
+    for (;;) {
+        off_t here;
+        SYSCALL(here = ::ftello(f));
+
+        // message headers only, seeking past the rest of the message (otherwise, the whole message)
+        auto len = read_headers(f, here, buffer);
+        if (len > 0) {
+            SYSCALL(::fseeko(f, here + off_t(len), SEEK_SET));
+        }
+        else {
+            SYSCALL(::fseeko(f, here, SEEK_SET));
+            if (!read_message(f, buffer)) {
+                break;
+            }
+
+            len = buffer.size();
+            SYSCALL(here = ::ftello(f));
+            here -= off_t(len);
+        }
+
+        // headers only (no values decoding)
+        auto* h = codes_handle_new_from_partial_message(nullptr, buffer.data(), buffer.size());
+        ASSERT(h != nullptr);
+        HandleDeleter hd(h);
+
+        Entry entry{here, len, {}};
+        entry.values.reserve(keys_.size());
+
+        for (const auto& key : keys_) {
+            char value[1024];
+            size_t length = sizeof(value);
+            entry.values.emplace_back(codes_get_string(h, key.c_str(), value, &length) == CODES_SUCCESS ? value : "");
+        }
+
+        entries_.emplace_back(std::move(entry));
+    }
+}
+
+
+size_t GribFileIndex::read_headers(FILE* f, off_t here, std::vector<unsigned char>& header) const {
+    // big-endian unsigned integer
+    auto uint = [](const unsigned char* p, size_t n) {
+        size_t v = 0;
+        for (size_t i = 0; i < n; ++i) {
+            v = (v << 8) | p[i];
+        }
+        return v;
+    };
+
+    auto read = [f, &header](size_t pos, size_t n) {
+        header.resize(pos + n);
+        return ::fread(header.data() + pos, 1, n, f) == n;
+    };
+
+    // section 0 (indicator), and the start of section 1 for edition 1
+    if (!read(0, 16) || std::memcmp(header.data(), "GRIB", 4) != 0) {
+        return 0;
+    }
+
+    size_t total = 0;
+    size_t pos   = 0;
+
+    if (header[7] == 2) {
+        total = uint(&header[8], 8);
+
+        // sections 1 to 5 (bitmap and data sections, 6 and 7, are not read)
+        for (pos = 16;; pos += uint(&header[pos], 4)) {
+            if (!read(pos, 5)) {
+                return 0;
+            }
+
+            const auto len = uint(&header[pos], 4);
+            if (header[pos + 4] >= 6 || len < 5 || pos + len > total) {
+                break;
+            }
+
+            if (!read(pos + 5, len - 5)) {
+                return 0;
+            }
+        }
+    }
+    else if (header[7] == 1) {
+        total = uint(&header[4], 3);
+        if ((total & 0x800000) != 0) {
+            return 0;  // large message, the length is encoded differently
+        }
+
+        // sections 1 and 2 (optional grid description, flagged in section 1)
+        const auto len1 = uint(&header[8], 3);
+        if (len1 < 8 || !read(16, len1 - 8)) {
+            return 0;
+        }
+
+        pos = 8 + len1;
+        if ((header[15] & 0x80) != 0) {
+            if (!read(pos, 3)) {
+                return 0;
+            }
+
+            const auto len2 = uint(&header[pos], 3);
+            if (len2 < 3 || !read(pos + 3, len2 - 3)) {
+                return 0;
+            }
+            pos += len2;
+        }
+    }
+    else {
+        return 0;
+    }
+
+    if (pos > total || static_cast<unsigned long long>(here) + total > size_) {
+        return 0;
+    }
+
+    header.resize(pos);
+    return total;
+}
+
+
+bool GribFileIndex::read_message(FILE* f, std::vector<unsigned char>& buffer) {
+    off_t here;
+    SYSCALL(here = ::ftello(f));
+
+    if (buffer.size() < 1024 * 1024) {
+        buffer.resize(1024 * 1024);
+    }
+
+    for (;;) {
+        size_t len = buffer.size();
+        int e      = wmo_read_any_from_file(f, buffer.data(), &len);
+
+        if (e == CODES_END_OF_FILE) {
+            return false;
+        }
+
+        // no size limit, re-read into a larger buffer
+        if (e == CODES_BUFFER_TOO_SMALL) {
+            buffer.resize(len);
+            SYSCALL(::fseeko(f, here, SEEK_SET));
+            continue;
+        }
+
+        if (e != CODES_SUCCESS) {
+            GRIB_ERROR(e, "wmo_read_any_from_file");
+        }
+
+        buffer.resize(len);
+        return true;
+    }
+}
+
+
+bool GribFileIndex::load(const eckit::PathName& path) {
+    std::ifstream in(path.asString());
+    std::string line;
+
+    // check index is for this file contents and keys
+    auto next = [&in, &line]() { return bool(std::getline(in, line)); };
+
+    std::ostringstream file;
+    file << size_ << '\t' << modified_;
+
+    if (!next() || line != MAGIC || !next() || line != file.str() || !next() || line != join(keys_) || !next()) {
+        return false;
+    }
+
+    const auto count = std::stoul(line);
+    std::vector<Entry> entries;
+    entries.reserve(count);
+
+    while (next()) {
+        auto v = split(line);
+        if (v.size() != keys_.size() + 2) {
+            return false;
+        }
+
+        entries.push_back({static_cast<off_t>(std::stoll(v[0])), std::stoul(v[1]), {v.begin() + 2, v.end()}});
+    }
+
+    if (entries.size() != count) {
+        return false;
+    }
+
+    entries_.swap(entries);
+    return true;
+}
+
+
+void GribFileIndex::save(const eckit::PathName& path) const {
+    auto dir = path.dirName();
+    if (!dir.exists()) {
+        dir.mkdir();
+    }
+
+    // write to a unique file, then rename (atomic) so concurrent readers only ever see a complete file
+    auto tmp = eckit::PathName::unique(path);
+    {
+        std::ofstream out(tmp.asString());
+        out << MAGIC << '\n' << size_ << '\t' << modified_ << '\n' << join(keys_) << '\n' << entries_.size() << '\n';
+
+        for (const auto& entry : entries_) {
+            out << entry.offset << '\t' << entry.length;
+            for (const auto& value : entry.values) {
+                out << '\t' << value;
+            }
+            out << '\n';
+        }
+
+        if (!out) {
+            throw exception::WriteError("GribFileIndex: error writing '" + tmp.asString() + "'");
+        }
+    }
+
+    eckit::PathName::rename(tmp, path);
+}
+
+
+void GribFileIndex::print(std::ostream& out) const {
+    out << "GribFileIndex[path=" << path_ << ",entries=" << entries_.size() << "]";
+}
+
+
+}  // namespace mir::input
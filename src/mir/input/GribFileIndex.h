@@ -0,0 +1,100 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <cstdio>
+#include <ctime>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+
+
+namespace mir::input {
+
+
+/**
+ * Messages of a GRIB file (offset, length) with a set of header keys, built once by reading the message headers only
+ * (sections 0 to 5 in edition 2, 0 to 2 in edition 1) and seeking past the rest, so no values are read. Depending on
+ * $MIR_GRIB_INDEX ("memory", "file" or "cache", "off" to disable), the index is kept in memory only, or persisted next
+ * to the file or in the MIR cache directory. Indexed keys are set by $MIR_GRIB_INDEX_KEYS (comma-separated).
+ */
+class GribFileIndex {
+public:
+    // -- Types
+
+    struct Entry {
+        off_t offset;
+        size_t length;
+        std::vector<std::string> values;  // in the order of keys()
+    };
+
+    // -- Constructors
+
+    explicit GribFileIndex(const eckit::PathName&);
+
+    GribFileIndex(const GribFileIndex&) = delete;
+    GribFileIndex(GribFileIndex&&)      = delete;
+
+    // -- Destructor
+
+    ~GribFileIndex();
+
+    // -- Operators
+
+    void operator=(const GribFileIndex&) = delete;
+    void operator=(GribFileIndex&&)      = delete;
+
+    // -- Methods
+
+    const std::vector<std::string>& keys() const { return keys_; }
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    bool indexed(const std::string& key) const;
+
+    /// First entry at or after from with key value, entries().size() if not found
+    size_t find(size_t from, const std::string& key, const std::string& value) const;
+
+    /// Index is used to select messages (not "off")
+    static bool enabled();
+
+private:
+    // -- Members
+
+    const eckit::PathName path_;
+    unsigned long long size_;
+    std::time_t modified_;
+    std::vector<std::string> keys_;
+    std::vector<Entry> entries_;
+
+    // -- Methods
+
+    void build();
+    size_t read_headers(FILE*, off_t, std::vector<unsigned char>& header) const;
+    static bool read_message(FILE*, std::vector<unsigned char>& buffer);
+    bool load(const eckit::PathName&);
+    void save(const eckit::PathName&) const;
+
+    void print(std::ostream&) const;
+
+    // -- Friends
+
+    friend std::ostream& operator<<(std::ostream& out, const GribFileIndex& index) {
+        index.print(out);
+        return out;
+    }
+};
+
+
+}  // namespace mir::input
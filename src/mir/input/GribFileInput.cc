@@ -12,21 +12,33 @@
 
 #include "mir/input/GribFileInput.h"
 
+#include <memory>
+#include <string>
+
+#include "eckit/config/Resource.h"
 #include "eckit/io/BufferedHandle.h"
+#include "eckit/io/StdFile.h"
+
+#include "mir/input/GribFileIndex.h"
+#include "mir/input/GribMappedFileInput.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Grib.h"
+#include "mir/util/Log.h"
 
 
 namespace mir::input {
 
 
 GribFileInput::GribFileInput(const eckit::PathName& path, size_t skip, size_t step) :
-    GribStreamInput(skip, step), path_(path), handle_(nullptr) {}
+    GribStreamInput(skip, step), path_(path), handle_(nullptr), indexNext_(0) {}
 
 GribFileInput::GribFileInput(const eckit::PathName& path, off_t offset) :
-    GribStreamInput(offset), path_(path), handle_(nullptr) {}
+    GribStreamInput(offset), path_(path), handle_(nullptr), indexNext_(0) {}
 
-GribFileInput::GribFileInput(const eckit::PathName& path) : path_(path), handle_(nullptr) {}
+GribFileInput::GribFileInput(const eckit::PathName& path) : path_(path), handle_(nullptr), indexNext_(0) {}
 
 GribFileInput::~GribFileInput() {
+    stop();
     if (handle_ != nullptr) {
         handle_->close();
         delete handle_;
@@ -42,6 +54,44 @@ void GribFileInput::print(std::ostream& out) const {
     out << "GribFileInput[path=" << path_ << ",skip=" << skip_ << ", step=" << step_ << "]";
 }
 
+bool GribFileInput::only(size_t paramId) {
+    // select messages from the index (not decoding all messages), if reading the whole file
+    if (!GribFileIndex::enabled() || skip_ != 0 || step_ != 1 || offset_ != 0) {
+        return GribInput::only(paramId);
+    }
+
+    if (!index_) {
+        index_     = std::make_unique<GribFileIndex>(path_);
+        indexNext_ = 0;
+    }
+
+    if (!index_->indexed("paramId")) {
+        return GribInput::only(paramId);
+    }
+
+    handle(nullptr);
+
+    const auto& entries = index_->entries();
+    auto i              = index_->find(indexNext_, "paramId", std::to_string(paramId));
+    if (i == entries.size()) {
+        indexNext_ = i;
+        return false;
+    }
+
+    indexNext_ = i + 1;
+
+    // read message
+    const auto& entry = entries[i];
+    indexed_.resize(entry.length);
+
+    eckit::AutoStdFile f(path_);
+    SYSCALL(::fseeko(f, entry.offset, SEEK_SET));
+    ASSERT(::fread(indexed_.data(), 1, indexed_.size(), f) == indexed_.size());
+
+    ASSERT(handle(codes_handle_new_from_message(nullptr, indexed_.data(), indexed_.size())));
+    return true;
+}
+
 eckit::DataHandle& GribFileInput::dataHandle() {
     if (handle_ == nullptr) {
         handle_ = new eckit::BufferedHandle(path_.fileHandle());
@@ -50,7 +100,22 @@ eckit::DataHandle& GribFileInput::dataHandle() {
     return *handle_;
 }
 
-static const MIRInputBuilder<GribFileInput> input(0x47524942);  // "GRIB"
+class GribFileInputFactory final : public MIRInputFactory {
+    MIRInput* make(const std::string& path) override {
+        // memory-mapped input, if requested
+        static const bool mmap = eckit::Resource<bool>("$MIR_GRIB_INPUT_MMAP", false);
+        if (mmap) {
+            return new GribMappedFileInput(path);
+        }
+        return new GribFileInput(path);
+    }
+
+public:
+    explicit GribFileInputFactory(unsigned long magic) : MIRInputFactory(magic) {}
+};
+
+
+static const GribFileInputFactory input(0x47524942);  // "GRIB"
 
 
 }  // namespace mir::input
@@ -12,11 +12,19 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "eckit/filesystem/PathName.h"
 
 #include "mir/input/GribStreamInput.h"
 
 
+namespace mir::input {
+class GribFileIndex;
+}
+
+
 namespace mir::input {
 
 
@@ -75,6 +83,10 @@ private:
     eckit::PathName path_;
     eckit::DataHandle* handle_;
 
+    std::unique_ptr<GribFileIndex> index_;
+    size_t indexNext_;
+    std::vector<char> indexed_;
+
     // -- Methods
     // None
 
@@ -83,6 +95,7 @@ private:
     // From MIRInput
     void print(std::ostream&) const override;
     bool sameAs(const MIRInput&) const override;
+    bool only(size_t paramId) override;
 
     // From GribInput
     eckit::DataHandle& dataHandle() override;
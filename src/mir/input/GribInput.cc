@@ -730,37 +730,24 @@ data::MIRField GribInput::field() const {
     size_t values_size = 0;
     GRIB_CALL(codes_get_size(grib_, "values", &values_size));
 
-    size_t size = values_size;
-    MIRValuesVector values(values_size);
-    GRIB_CALL(codes_get_double_array(grib_, "values", values.data(), &size));
-
-    if (values_size != size) {
-        wrongly_encoded_grib("GribInput: inconsistent encoding of 'values' size (" + std::to_string(values_size) +
-                                 ") and array length (" + std::to_string(size) + ")",
-                             true);
-    }
-
     long missingValuesPresent = 0;
     GRIB_CALL(codes_get_long(grib_, "missingValuesPresent", &missingValuesPresent));
 
     double missingValue = 0;
     GRIB_CALL(codes_get_double(grib_, "missingValue", &missingValue));
 
-    // Ensure missingValue is unique, so values are not wrongly "missing"
-    long numberOfMissingValues = 0;
-    GRIB_GET(codes_get_long(grib_, "numberOfMissingValues", &numberOfMissingValues));
-    if (numberOfMissingValues == 0) {
-        grib_get_unique_missing_value(values, missingValue);
-    }
+    // If grib has a 0-containing pl array, values are decoded into a buffer and then copied to their final layout, with
+    // missing values in place of the 0 entries; otherwise, values are decoded in their final layout
+    std::vector<long> pl;
+    std::vector<long> pl_fixed;
 
-    // If grib has a 0-containing pl array, add missing values in their place
     if (has("pl")) {
         size_t pl_size = 0;
         GRIB_CALL(codes_get_size(grib_, "pl", &pl_size));
         ASSERT(pl_size > 0);
 
-        std::vector<long> pl(pl_size, 0);
-        size = pl_size;
+        pl.assign(pl_size, 0);
+        size_t size = pl_size;
         GRIB_CALL(codes_get_long_array(grib_, "pl", pl.data(), &size));
 
         if (pl_size != size) {
@@ -769,58 +756,79 @@ data::MIRField GribInput::field() const {
                                  true);
         }
 
-        if (auto pl_sum = static_cast<size_t>(std::accumulate(pl.begin(), pl.end(), 0L)); pl_sum != values.size()) {
+        if (auto pl_sum = static_cast<size_t>(std::accumulate(pl.begin(), pl.end(), 0L)); pl_sum != values_size) {
             wrongly_encoded_grib("GribInput: sum of pl array (" + std::to_string(pl_sum) +
-                                 ") does not match the size of values array (" + std::to_string(values.size()) + ")");
+                                 ") does not match the size of values array (" + std::to_string(values_size) + ")");
         }
 
         // NOTE: this fix ties with the method get(const std::string &name, std::vector<long> &value)
         if (std::find(pl.rbegin(), pl.rend(), 0) != pl.rend()) {
+            pl_fixed = pl;
+        }
+    }
 
-            // if there are no missing values yet, set them
-            if (missingValuesPresent == 0) {
-                Log::debug() << "GribInput: introducing missing values (setting bitmap)" << std::endl;
-                missingValuesPresent = 1;
-                grib_get_unique_missing_value(values, missingValue);
-            }
+    MIRValuesVector buffer;
+    MIRValuesVector values;
+    auto& decoded = pl_fixed.empty() ? values : buffer;
+    decoded.resize(values_size);
 
-            // pl array: insert entries in place of zeros
-            std::vector<long> pl_fixed = pl;
-            size_t new_values          = fix_pl_array_zeros(pl_fixed);
-            ASSERT(new_values > 0);
-
-            // values array: copy values row by row, and when a fixed (0) entry is found, insert missing values
-            Log::debug() << "GribInput: correcting values array with " << new_values << " new missing values"
-                         << std::endl;
-
-            MIRValuesVector values_extended;
-            values_extended.reserve(values_size + new_values);
-
-            ASSERT(pl.size() == pl_fixed.size());
-            size_t i = 0;
-            for (auto p1 = pl.begin(), p2 = pl_fixed.begin(); p1 != pl.end(); ++p1, ++p2) {
-                if (*p1 == 0) {
-                    ASSERT(*p2 > 0);
-                    auto Ni = static_cast<size_t>(*p2);
-                    values_extended.insert(values_extended.end(), Ni, missingValue);
-                }
-                else {
-                    auto Ni = static_cast<size_t>(*p1);
-                    ASSERT(i + Ni <= values_size);
+    size_t size = values_size;
+    GRIB_CALL(codes_get_double_array(grib_, "values", decoded.data(), &size));
 
-                    values_extended.insert(values_extended.end(), &values[i], &values[i + Ni]);
-                    i += Ni;
-                }
-            }
+    if (values_size != size) {
+        wrongly_encoded_grib("GribInput: inconsistent encoding of 'values' size (" + std::to_string(values_size) +
+                                 ") and array length (" + std::to_string(size) + ")",
+                             true);
+    }
 
-            // set the new (extended) values vector, confirm it is compatible with a returned pl array
-            ASSERT(values.size() + new_values == values_extended.size());
-            values.swap(values_extended);
+    // Ensure missingValue is unique, so values are not wrongly "missing"
+    long numberOfMissingValues = 0;
+    GRIB_GET(codes_get_long(grib_, "numberOfMissingValues", &numberOfMissingValues));
+    if (numberOfMissingValues == 0) {
+        grib_get_unique_missing_value(decoded, missingValue);
+    }
 
-            ASSERT(get("pl", pl));
-            auto pl_sum = static_cast<size_t>(std::accumulate(pl.begin(), pl.end(), 0L));
-            ASSERT(pl_sum == values.size());
+    if (!pl_fixed.empty()) {
+
+        // if there are no missing values yet, set them
+        if (missingValuesPresent == 0) {
+            Log::debug() << "GribInput: introducing missing values (setting bitmap)" << std::endl;
+            missingValuesPresent = 1;
+            grib_get_unique_missing_value(decoded, missingValue);
         }
+
+        // pl array: insert entries in place of zeros
+        size_t new_values = fix_pl_array_zeros(pl_fixed);
+        ASSERT(new_values > 0);
+
+        // values array: copy values row by row, and when a fixed (0) entry is found, insert missing values
+        Log::debug() << "GribInput: correcting values array with " << new_values << " new missing values"
+                     << std::endl;
+
+        values.reserve(values_size + new_values);
+
+        ASSERT(pl.size() == pl_fixed.size());
+        size_t i = 0;
+        for (auto p1 = pl.begin(), p2 = pl_fixed.begin(); p1 != pl.end(); ++p1, ++p2) {
+            if (*p1 == 0) {
+                ASSERT(*p2 > 0);
+                auto Ni = static_cast<size_t>(*p2);
+                values.insert(values.end(), Ni, missingValue);
+            }
+            else {
+                auto Ni = static_cast<size_t>(*p1);
+                ASSERT(i + Ni <= values_size);
+                values.insert(values.end(), decoded.begin() + i, decoded.begin() + i + Ni);
+                i += Ni;
+            }
+        }
+
+        // confirm the new (extended) values vector is compatible with a returned pl array
+        ASSERT(values_size + new_values == values.size());
+
+        ASSERT(get("pl", pl));
+        auto pl_sum = static_cast<size_t>(std::accumulate(pl.begin(), pl.end(), 0L));
+        ASSERT(pl_sum == values.size());
     }
 
     data::MIRField field(cache_, missingValuesPresent != 0, missingValue);
@@ -0,0 +1,158 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/input/GribMappedFileInput.h"
+
+#include <algorithm>
+#include <ostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "eckit/memory/MMap.h"
+#include "eckit/os/Stat.h"
+
+#include "mir/util/Exceptions.h"
+#include "mir/util/Grib.h"
+#include "mir/util/Log.h"
+
+
+namespace mir::input {
+
+
+GribMappedFileInput::GribMappedFileInput(const eckit::PathName& path, size_t skip, size_t step, off_t offset) :
+    path_(path),
+    skip_(skip),
+    step_(step),
+    offset_(offset),
+    fd_(-1),
+    address_(nullptr),
+    size_(0),
+    position_(0),
+    first_(true) {
+    ASSERT(step_ > 0);
+
+    fd_ = ::open(path.localPath(), O_RDONLY);
+    if (fd_ < 0) {
+        Log::error() << "open(" << path << ')' << Log::syserr << std::endl;
+        throw exception::FailedSystemCall("open");
+    }
+
+    eckit::Stat::Struct s;
+    SYSCALL(eckit::Stat::stat(path.localPath(), &s));
+    size_ = size_t(s.st_size);
+
+    if (size_ > 0) {
+        // copy-on-write, the file is not modified
+        auto* address = eckit::MMap::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd_, 0);
+        if (address == MAP_FAILED) {
+            Log::error() << "mmap(" << path << ',' << size_ << ')' << Log::syserr << std::endl;
+            SYSCALL(::close(fd_));
+            throw exception::FailedSystemCall("mmap");
+        }
+
+        address_ = static_cast<char*>(address);
+    }
+}
+
+
+GribMappedFileInput::GribMappedFileInput(const eckit::PathName& path, size_t skip, size_t step) :
+    GribMappedFileInput(path, skip, step, 0) {}
+
+
+GribMappedFileInput::GribMappedFileInput(const eckit::PathName& path, off_t offset) :
+    GribMappedFileInput(path, 0, 1, offset) {}
+
+
+GribMappedFileInput::GribMappedFileInput(const eckit::PathName& path) : GribMappedFileInput(path, 0, 1, 0) {}
+
+
+GribMappedFileInput::~GribMappedFileInput() {
+    // handles reference the mapped memory
+    handle(nullptr);
+
+    if (address_ != nullptr) {
+        SYSCALL(eckit::MMap::munmap(address_, size_));
+    }
+
+    if (fd_ >= 0) {
+        SYSCALL(::close(fd_));
+    }
+}
+
+
+grib_handle* GribMappedFileInput::message() {
+    static const char MAGIC[] = "GRIB";
+
+    const char* begin = address_ + position_;
+    const char* end   = address_ + size_;
+    const auto* start = std::search(begin, end, MAGIC, MAGIC + 4);
+    if (start == end) {
+        position_ = size_;
+        return nullptr;
+    }
+
+    // handle references the mapped message
+    const auto offset = static_cast<size_t>(start - address_);
+    auto* h           = codes_handle_new_from_message(nullptr, address_ + offset, size_ - offset);
+    ASSERT(h != nullptr);
+
+    size_t len = 0;
+    GRIB_CALL(codes_get_message_size(h, &len));
+    ASSERT(len > 0 && offset + len <= size_);
+
+    position_ = offset + len;
+    return h;
+}
+
+
+bool GribMappedFileInput::next() {
+    handle(nullptr);
+
+    // Skip a few message if needed
+    size_t advance = step_ - 1;
+
+    if (first_) {
+        first_  = false;
+        advance = skip_;
+
+        ASSERT(offset_ >= 0 && size_t(offset_) <= size_);
+        position_ = size_t(offset_);
+    }
+
+    for (size_t i = 0; i < advance; i++) {
+        auto* h = message();
+        if (h == nullptr) {
+            return false;
+        }
+        codes_handle_delete(h);
+    }
+
+    auto* h = message();
+    return h != nullptr && handle(h);
+}
+
+
+void GribMappedFileInput::print(std::ostream& out) const {
+    out << "GribMappedFileInput[path=" << path_ << ",skip=" << skip_ << ",step=" << step_
+        << ",size=" << Log::Bytes(size_) << "]";
+}
+
+
+bool GribMappedFileInput::sameAs(const MIRInput& other) const {
+    const auto* o = dynamic_cast<const GribMappedFileInput*>(&other);
+    return (o != nullptr) && (skip_ == o->skip_) && (step_ == o->step_) && (path_ == o->path_);
+}
+
+
+}  // namespace mir::input
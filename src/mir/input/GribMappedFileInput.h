@@ -0,0 +1,101 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include "eckit/filesystem/PathName.h"
+
+#include "mir/input/GribInput.h"
+
+
+namespace mir::input {
+
+
+/**
+ * GRIB file input mapped in memory: handles reference the mapped messages (not copied), mapped copy-on-write so
+ * handles can still be modified. Selected for GRIB files with $MIR_GRIB_INPUT_MMAP=1.
+ */
+class GribMappedFileInput : public GribInput {
+public:
+    // -- Exceptions
+    // None
+
+    // -- Constructors
+
+    GribMappedFileInput(const eckit::PathName&, size_t skip, size_t step);
+    GribMappedFileInput(const eckit::PathName&, off_t offset);
+    explicit GribMappedFileInput(const eckit::PathName&);
+
+    // -- Destructor
+
+    ~GribMappedFileInput() override;
+
+    // -- Convertors
+    // None
+
+    // -- Operators
+    // None
+
+    // -- Methods
+    // None
+
+    // -- Overridden methods
+
+    bool next() override;
+
+    // -- Class members
+    // None
+
+    // -- Class methods
+    // None
+
+private:
+    // -- Constructors
+
+    GribMappedFileInput(const eckit::PathName&, size_t skip, size_t step, off_t offset);
+
+    // -- Members
+
+    const eckit::PathName path_;
+    const size_t skip_;
+    const size_t step_;
+    const off_t offset_;
+
+    int fd_;
+    char* address_;
+    size_t size_;
+    size_t position_;
+    bool first_;
+
+    // -- Methods
+
+    /// Handle of the next message (advancing past it), nullptr at end of file
+    grib_handle* message();
+
+    // -- Overridden methods
+
+    // From MIRInput
+    void print(std::ostream&) const override;
+    bool sameAs(const MIRInput&) const override;
+
+    // -- Class members
+    // None
+
+    // -- Class methods
+    // None
+
+    // -- Friends
+    // None
+};
+
+
+}  // namespace mir::input
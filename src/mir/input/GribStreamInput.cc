@@ -12,6 +12,13 @@
 
 #include "mir/input/GribStreamInput.h"
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
 #include "eckit/config/Resource.h"
 #include "eckit/io/DataHandle.h"
 
@@ -30,6 +37,13 @@ static size_t buffer_size() {
 }
 
 
+static size_t read_ahead_budget() {
+    // bytes of messages read ahead (at least one message), 0 to read synchronously
+    static size_t budget = eckit::Resource<size_t>("$MIR_GRIB_INPUT_READ_AHEAD", 0);
+    return budget;
+}
+
+
 static long readcb(void* data, void* buffer, long len) {
     auto* handle = reinterpret_cast<eckit::DataHandle*>(data);
     long l       = handle->read(buffer, len);
@@ -38,65 +52,156 @@ static long readcb(void* data, void* buffer, long len) {
 }
 
 
+/// Reads messages on a separate thread into a queue, within a byte budget
+class GribStreamInput::ReadAhead {
+public:
+    ReadAhead(GribStreamInput& owner, size_t budget) : owner_(owner), budget_(budget) {
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ReadAhead(const ReadAhead&) = delete;
+    ReadAhead(ReadAhead&&)      = delete;
+
+    ~ReadAhead() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cond_.notify_all();
+        thread_.join();
+    }
+
+    void operator=(const ReadAhead&) = delete;
+    void operator=(ReadAhead&&)      = delete;
+
+    /// Next message, false at end of stream (re-throws reading errors, in order)
+    bool next(std::vector<char>& message) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this]() { return !queue_.empty() || eof_ || error_; });
+
+        if (!queue_.empty()) {
+            message = std::move(queue_.front());
+            queue_.pop_front();
+
+            bytes_ -= message.size();
+            cond_.notify_all();
+            return true;
+        }
+
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+
+        return false;
+    }
+
+private:
+    GribStreamInput& owner_;
+    const size_t budget_;
+
+    std::deque<std::vector<char>> queue_;
+    size_t bytes_ = 0;
+    bool eof_     = false;
+    bool stop_    = false;
+    std::exception_ptr error_;
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::thread thread_;
+
+    void run() {
+        try {
+            for (;;) {
+                size_t len = 0;
+                bool more  = true;
+                for (size_t i = owner_.advance(); more && i > 0; --i) {
+                    more = owner_.read(len);
+                }
+
+                if (!more || !owner_.read(len)) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    eof_ = true;
+                    cond_.notify_all();
+                    return;
+                }
+
+                const auto* data = static_cast<const char*>(owner_.buffer_.data());
+                std::vector<char> message(data, data + len);
+
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [this, len]() { return stop_ || bytes_ == 0 || bytes_ + len <= budget_; });
+                if (stop_) {
+                    return;
+                }
+
+                bytes_ += len;
+                queue_.emplace_back(std::move(message));
+                cond_.notify_all();
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+            cond_.notify_all();
+        }
+    }
+};
+
+
 GribStreamInput::GribStreamInput(size_t skip, size_t step) :
-    skip_(skip), step_(step), offset_(0), buffer_(buffer_size()), first_(true) {
+    skip_(skip),
+    step_(step),
+    offset_(0),
+    buffer_(buffer_size()),
+    first_(true),
+    readAheadBudget_(read_ahead_budget()) {
     ASSERT(step_ > 0);
 }
 
 
 GribStreamInput::GribStreamInput(off_t offset) :
-    skip_(0), step_(1), offset_(offset), buffer_(buffer_size()), first_(true) {
+    skip_(0), step_(1), offset_(offset), buffer_(buffer_size()), first_(true), readAheadBudget_(read_ahead_budget()) {
     ASSERT(step_ > 0);
 }
 
 
-GribStreamInput::GribStreamInput() : skip_(0), step_(1), offset_(0), buffer_(buffer_size()), first_(true) {
+GribStreamInput::GribStreamInput() :
+    skip_(0), step_(1), offset_(0), buffer_(buffer_size()), first_(true), readAheadBudget_(read_ahead_budget()) {
     ASSERT(step_ > 0);
 }
 
 
-GribStreamInput::~GribStreamInput() = default;
-
+GribStreamInput::~GribStreamInput() {
+    stop();
+}
 
-bool GribStreamInput::next() {
 
-    handle(nullptr);
+void GribStreamInput::stop() {
+    readAheadBudget_ = 0;
+    readAhead_.reset();
+}
 
-    // Skip a few message if needed
-    size_t advance = step_ - 1;
 
+size_t GribStreamInput::advance() {
     if (first_) {
-        first_  = false;
-        advance = skip_;
+        first_ = false;
 
         if (offset_ != 0) {
             dataHandle().skip(offset_);
         }
-    }
 
-    for (size_t i = 0; i < advance; i++) {
-        size_t len = buffer_.size();
-        int e      = wmo_read_any_from_stream(&dataHandle(), &readcb, buffer_, &len);
-        if (e == CODES_END_OF_FILE) {
-            return false;
-        }
+        return skip_;
+    }
 
-        if (e == CODES_BUFFER_TOO_SMALL) {
-            Log::debug() << "GribStreamInput::next() message is " << len << " bytes (" << Log::Bytes(len) << ")"
-                         << std::endl;
-            GRIB_ERROR(e, "wmo_read_any_from_stream");
-        }
+    return step_ - 1;
+}
 
-        if (e != CODES_SUCCESS) {
-            GRIB_ERROR(e, "wmo_read_any_from_stream");
-        }
-    }
 
-    size_t len = buffer_.size();
-    int e      = wmo_read_any_from_stream(&dataHandle(), &readcb, buffer_, &len);
+bool GribStreamInput::read(size_t& len) {
+    len   = buffer_.size();
+    int e = wmo_read_any_from_stream(&dataHandle(), &readcb, buffer_, &len);
 
     if (e == CODES_SUCCESS) {
-        ASSERT(handle(codes_handle_new_from_message(nullptr, buffer_, len)));
         return true;
     }
 
@@ -104,14 +209,12 @@ bool GribStreamInput::next() {
         return false;
     }
 
-
     if (e == CODES_BUFFER_TOO_SMALL) {
         Log::debug() << "GribStreamInput::next() message is " << len << " bytes (" << Log::Bytes(len) << ")"
                      << std::endl;
         Log::debug() << "Buffer size is " << buffer_.size() << " bytes (" << Log::Bytes(buffer_.size())
                      << "), rerun with:" << std::endl;
         Log::debug() << "env MIR_GRIB_INPUT_BUFFER_SIZE=" << len << std::endl;
-        GRIB_ERROR(e, "wmo_read_any_from_stream");
     }
 
     GRIB_ERROR(e, "wmo_read_any_from_stream");
@@ -120,4 +223,40 @@ bool GribStreamInput::next() {
 }
 
 
+bool GribStreamInput::next() {
+
+    handle(nullptr);
+
+    if (readAheadBudget_ > 0) {
+        if (!readAhead_) {
+            Log::debug() << "GribStreamInput: reading ahead up to " << Log::Bytes(readAheadBudget_) << std::endl;
+            readAhead_ = std::make_unique<ReadAhead>(*this, readAheadBudget_);
+        }
+
+        // handles are created on this thread, from messages read ahead
+        if (!readAhead_->next(message_)) {
+            return false;
+        }
+
+        ASSERT(handle(codes_handle_new_from_message(nullptr, message_.data(), message_.size())));
+        return true;
+    }
+
+    // Skip a few message if needed
+    size_t len = 0;
+    for (size_t i = advance(); i > 0; --i) {
+        if (!read(len)) {
+            return false;
+        }
+    }
+
+    if (read(len)) {
+        ASSERT(handle(codes_handle_new_from_message(nullptr, buffer_, len)));
+        return true;
+    }
+
+    return false;
+}
+
+
 }  // namespace mir::input
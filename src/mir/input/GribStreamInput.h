@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "eckit/io/Buffer.h"
 
 #include "mir/input/GribInput.h"
@@ -66,7 +69,9 @@ protected:
     off_t offset_;
 
     // -- Methods
-    // None
+
+    /// Stop reading ahead, derived classes should call it before releasing their data handle
+    void stop();
 
     // -- Overridden methods
     // None
@@ -78,16 +83,29 @@ protected:
     // None
 
 private:
+    // -- Types
+
+    class ReadAhead;
+
     // -- Members
 
     eckit::Buffer buffer_;
     bool first_;
 
+    size_t readAheadBudget_;
+    std::unique_ptr<ReadAhead> readAhead_;
+    std::vector<char> message_;
 
     // -- Methods
 
     virtual eckit::DataHandle& dataHandle() = 0;
 
+    /// Number of messages to skip before the next message
+    size_t advance();
+
+    /// Read next message into buffer, false at end of stream
+    bool read(size_t& len);
+
     // -- Overridden methods
     // None
 
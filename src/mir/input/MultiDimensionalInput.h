@@ -18,6 +18,7 @@
 
 
 namespace mir::output {
+class BatchOutput;
 class MultiDimensionalOutput;
 }  // namespace mir::output
 
@@ -101,6 +102,7 @@ private:
 
     // -- Friends
 
+    friend class output::BatchOutput;
     friend class output::MultiDimensionalOutput;
 };
 
@@ -21,31 +21,21 @@
 #include "eckit/utils/MD5.h"
 #include "eckit/utils/StringTools.h"
 
-#include "mir/api/mir_config.h"
 #include "mir/param/CombinedParametrisation.h"
 #include "mir/param/MIRParametrisation.h"
 #include "mir/param/SimpleParametrisation.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
 #include "mir/util/Mutex.h"
+#include "mir/util/Parallel.h"
 #include "mir/util/ValueMap.h"
 
 
-extern "C" {
-void omp_set_num_threads(int);
-}
-
-
 namespace mir::method {
 
 
 Method::Method(const param::MIRParametrisation& params) : parametrisation_(params) {
-    if constexpr (MIR_HAVE_OMP) {
-        int num_threads = 1;
-        if (params.get("parallel-omp-num-threads", num_threads)) {
-            omp_set_num_threads(num_threads);
-        }
-    }
+    util::parallel_omp_num_threads(params);
 }
 
 
@@ -13,10 +13,16 @@
 #include "mir/method/MethodWeighted.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <limits>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "eckit/config/Resource.h"
 #include "eckit/filesystem/PathName.h"
@@ -34,15 +40,19 @@
 #include "mir/data/Space.h"
 #include "mir/lsm/LandSeaMasks.h"
 #include "mir/method/MatrixCacheCreator.h"
+#include "mir/method/WeightMatrixBuilder.h"
+#include "mir/method/WeightMatrixSinglePrecision.h"
+#include "mir/method/WeightMatrixStructure.h"
 #include "mir/method/nonlinear/NonLinear.h"
 #include "mir/method/solver/Multiply.h"
 #include "mir/param/DefaultParametrisation.h"
 #include "mir/param/MIRParametrisation.h"
 #include "mir/repres/Representation.h"
 #include "mir/util/Exceptions.h"
+#include "mir/util/KeyedMutex.h"
 #include "mir/util/Log.h"
 #include "mir/util/MIRStatistics.h"
-#include "mir/util/Mutex.h"
+#include "mir/util/Parallel.h"
 #include "mir/util/Reorder.h"
 #include "mir/util/Trace.h"
 #include "mir/util/Types.h"
@@ -51,11 +61,179 @@
 namespace mir::method {
 
 
-static util::recursive_mutex MUTEX;
+static util::KeyedMutex MATRIX_MUTEX;
+static util::KeyedMutex MATRIX_SINGLE_PRECISION_MUTEX;
+static util::KeyedMutex MATRIX_ADJUSTED_MUTEX;
+static util::KeyedMutex MATRIX_REORDER_MUTEX;
+
+
+struct MethodWeighted::CachedMatrix {
+    WeightMatrix matrix;
+    WeightMatrixStructure structure;
+    std::string key;
+};
+
 
 constexpr size_t MIR_MATRIX_CACHE_MEMORY_FOOTPRINT = 512 * 1024 * 1024;  // capacity
-static caching::InMemoryCache<WeightMatrix> MATRIX_CACHE_MEMORY("mirMatrix", MIR_MATRIX_CACHE_MEMORY_FOOTPRINT, 0,
-                                                                "$MIR_MATRIX_CACHE_MEMORY_FOOTPRINT");
+static caching::InMemoryCache<MethodWeighted::CachedMatrix> MATRIX_CACHE_MEMORY("mirMatrix",
+                                                                                MIR_MATRIX_CACHE_MEMORY_FOOTPRINT, 0,
+                                                                                "$MIR_MATRIX_CACHE_MEMORY_FOOTPRINT");
+static caching::InMemoryCache<WeightMatrixSinglePrecision> MATRIX_SINGLE_PRECISION_CACHE_MEMORY(
+    "mirMatrixSinglePrecision", MIR_MATRIX_CACHE_MEMORY_FOOTPRINT, 0,
+    "$MIR_MATRIX_SINGLE_PRECISION_CACHE_MEMORY_FOOTPRINT");
+
+
+// matrix rows modified by the non-linear treatments (only these are stored, the others are the cached matrix rows)
+struct AdjustedMatrix {
+    std::vector<size_t> rows;                   // modified rows, ascending
+    std::vector<size_t> offsets{0};             // row weights start, per modified row (and end)
+    std::vector<WeightMatrix::Scalar> weights;  // modified row weights (columns as in the cached matrix row)
+    size_t occurrences = 0;
+    bool adjusted      = false;
+
+    size_t footprint() const {
+        return sizeof(*this) + rows.capacity() * sizeof(size_t) + offsets.capacity() * sizeof(size_t) +
+               weights.capacity() * sizeof(WeightMatrix::Scalar);
+    }
+};
+
+
+// matrices adjusted by non-linear treatments, per input missing values mask (fields often share the same bitmap)
+static caching::InMemoryCache<AdjustedMatrix> MATRIX_ADJUSTED_CACHE_MEMORY(
+    "mirMatrixAdjusted", MIR_MATRIX_CACHE_MEMORY_FOOTPRINT, 0, "$MIR_MATRIX_ADJUSTED_CACHE_MEMORY_FOOTPRINT");
+
+
+// digest of the input missing values masks, as seen by each non-linear treatment (in order)
+static std::string missing_mask_digest(const std::vector<std::unique_ptr<const nonlinear::NonLinear>>& nonLinear,
+                                       const MIRValuesVector& values, const double& missingValue) {
+    std::vector<std::uint64_t> mask((values.size() + 63) / 64);
+    eckit::MD5 hash;
+
+    for (const auto& n : nonLinear) {
+        std::fill(mask.begin(), mask.end(), 0);
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (n->isMissing(values[i], missingValue)) {
+                mask[i / 64] |= std::uint64_t(1) << (i % 64);
+            }
+        }
+        hash.add(mask.data(), long(mask.size() * sizeof(std::uint64_t)));
+    }
+
+    return hash.digest();
+}
+
+
+// B = W A, with the adjusted weights for the modified rows
+static void multiply_adjusted(const WeightMatrix& W, const AdjustedMatrix& M, const DenseMatrix& A, DenseMatrix& B,
+                              size_t threads) {
+    ASSERT(A.rows() == W.cols());
+    ASSERT(B.rows() == W.rows());
+    ASSERT(A.cols() == B.cols());
+
+    const auto* data  = W.data();
+    const auto* outer = W.outer();
+    const auto* inner = W.inner();
+    const auto Nc     = A.cols();
+
+    util::parallel_for_blocks(W.rows(), threads, [&](size_t /*block*/, size_t begin, size_t end) {
+        auto m = size_t(std::lower_bound(M.rows.begin(), M.rows.end(), begin) - M.rows.begin());
+
+        for (auto r = begin; r < end; ++r) {
+            const auto k = size_t(outer[r]);
+            const auto N = size_t(outer[r + 1]) - k;
+
+            const auto* weights = data + k;
+            if (m < M.rows.size() && M.rows[m] == r) {
+                weights = M.weights.data() + M.offsets[m++];
+            }
+
+            for (WeightMatrix::Size c = 0; c < Nc; ++c) {
+                double sum = 0.;
+                for (size_t j = 0; j < N; ++j) {
+                    if (weights[j] != 0.) {
+                        sum += weights[j] * A(WeightMatrix::Size(inner[k + j]), c);
+                    }
+                }
+                B(r, c) = sum;
+            }
+        }
+    });
+}
+
+
+struct PointsOrder {
+    std::vector<size_t> order;
+    size_t footprint() const { return sizeof(*this) + order.capacity() * sizeof(size_t); }
+};
+
+
+constexpr size_t MIR_MATRIX_REORDER_CACHE_MEMORY_FOOTPRINT = 64 * 1024 * 1024;  // capacity
+static caching::InMemoryCache<PointsOrder> MATRIX_REORDER_CACHE_MEMORY("mirMatrixReorder",
+                                                                       MIR_MATRIX_REORDER_CACHE_MEMORY_FOOTPRINT, 0,
+                                                                       "$MIR_MATRIX_REORDER_CACHE_MEMORY_FOOTPRINT");
+
+
+// new index of each representation point, cached in memory (callers are cache users, so entries are not purged)
+static const std::vector<size_t>& points_order(const std::string& name, const repres::Representation& rep) {
+    std::ostringstream str;
+    str << name << "/" << rep.uniqueName() << "/" << rep.numberOfPoints() << "/" << rep.boundingBox();
+    const auto key = str.str();
+
+    if (auto* j = MATRIX_REORDER_CACHE_MEMORY.find(key); j != MATRIX_REORDER_CACHE_MEMORY.end()) {
+        return j->order;
+    }
+
+    // single-flight (see getMatrix)
+    util::KeyedMutex::Lock lock(MATRIX_REORDER_MUTEX, key);
+
+    if (auto* j = MATRIX_REORDER_CACHE_MEMORY.find(key); j != MATRIX_REORDER_CACHE_MEMORY.end()) {
+        return j->order;
+    }
+
+    trace::Timer timer("MethodWeighted: reorder '" + name + "' " + rep.uniqueName());
+
+    // insert complete entry, as it is visible to other threads
+    std::unique_ptr<PointsOrder> entry(new PointsOrder);
+    entry->order = std::unique_ptr<util::Reorder>(util::Reorder::build(name, rep.numberOfPoints()))->reorder(rep);
+    ASSERT(entry->order.size() == rep.numberOfPoints());
+
+    auto& p = MATRIX_REORDER_CACHE_MEMORY.insert(key, entry.release());
+    MATRIX_REORDER_CACHE_MEMORY.footprint(key, caching::InMemoryCacheUsage(p.footprint(), 0));
+    return p.order;
+}
+
+
+// permute matrix rows and columns (new index of each row/column), writing compressed row storage directly
+static void reorder_matrix(WeightMatrix& W, const std::vector<size_t>& rows, const std::vector<size_t>& cols) {
+    ASSERT(rows.size() == W.rows());
+    ASSERT(cols.size() == W.cols());
+
+    // visit rows in their new order, renumbering columns directly
+    std::vector<size_t> inverse(rows.size(), rows.size());
+    for (size_t r = 0; r < rows.size(); ++r) {
+        ASSERT(rows[r] < inverse.size() && inverse[rows[r]] == inverse.size());
+        inverse[rows[r]] = r;
+    }
+
+    WeightMatrixBuilder builder(W.rows(), W.cols());
+    builder.reserve(W.nonZeros());
+
+    std::vector<std::pair<size_t, WeightMatrix::Scalar>> row;
+    for (size_t r = 0; r < inverse.size(); ++r) {
+        row.clear();
+        for (auto i = W.begin(inverse[r]), end = W.end(inverse[r]); i != end; ++i) {
+            row.emplace_back(cols.at(i.col()), *i);
+        }
+
+        std::sort(row.begin(), row.end());
+        for (const auto& [c, a] : row) {
+            builder.add(r, c, a);
+        }
+    }
+
+    // replace matrix
+    builder.build(W);
+}
 
 
 MethodWeighted::MethodWeighted(const param::MIRParametrisation& param) :
@@ -69,12 +247,18 @@ MethodWeighted::MethodWeighted(const param::MIRParametrisation& param) :
         std::string str;
         param.get("interpolation-matrix", str);
         return str;
-    }()) {
+    }()),
+    singlePrecision_(false) {
     ASSERT(lsmWeightAdjustment_ >= 0);
     ASSERT(pruneEpsilon_ >= 0);
     ASSERT(poleDisplacement_ >= 0);
 
     matrixAssemble_ = parametrisation_.userParametrisation().has("filter");
+    parametrisation_.get("matrix-single-precision", singlePrecision_);
+
+    if (parametrisation_.get("matrix-reorder", matrixReorder_) && matrixReorder_ == "identity") {
+        matrixReorder_.clear();
+    }
 
     std::string nonLinear = "missing-if-heaviest-missing";
     parametrisation_.get("non-linear", nonLinear);
@@ -108,6 +292,14 @@ void MethodWeighted::json(eckit::JSON& j) const {
     param::DefaultParametrisation::instance().json(j, "pole-displacement-in-degree", poleDisplacement_);
     param::DefaultParametrisation::instance().json(j, "prune-epsilon", pruneEpsilon_);
     param::DefaultParametrisation::instance().json(j, "lsm-weight-adjustment", lsmWeightAdjustment_);
+
+    if (singlePrecision_) {
+        j << "matrix-single-precision" << singlePrecision_;
+    }
+
+    if (!matrixReorder_.empty()) {
+        j << "matrix-reorder" << matrixReorder_;
+    }
 }
 
 
@@ -153,7 +345,8 @@ bool MethodWeighted::sameAs(const Method& other) const {
     return (o != nullptr) && (lsmWeightAdjustment_ == o->lsmWeightAdjustment_) && (pruneEpsilon_ == o->pruneEpsilon_) &&
            Latitude(poleDisplacement_) == Latitude(o->poleDisplacement_) &&
            (sameNonLinearities(nonLinear_, o->nonLinear_)) && solver().sameAs(o->solver()) &&
-           lsm::LandSeaMasks::sameLandSeaMasks(parametrisation_, o->parametrisation_) && cropping_.sameAs(o->cropping_);
+           lsm::LandSeaMasks::sameLandSeaMasks(parametrisation_, o->parametrisation_) &&
+           cropping_.sameAs(o->cropping_) && (singlePrecision_ == o->singlePrecision_);
 }
 
 
@@ -209,10 +402,52 @@ MethodWeighted::CacheKeys MethodWeighted::getDiskAndMemoryCacheKeys(const repres
 }
 
 
+eckit::PathName MethodWeighted::loadOrCreateMatrix(context::Context& ctx, const repres::Representation& in,
+                                                   const repres::Representation& out, const lsm::LandSeaMasks& masks,
+                                                   const std::string& disk_key, WeightMatrix& W) const {
+    eckit::PathName cacheFile;
+
+    bool caching = LibMir::caching();
+    parametrisation_.get("caching", caching);
+
+    if (caching) {
+        // WeightCache is parametrised by 'caching' (it may be disabled for specific fields, eg. unstructured grids)
+        static caching::WeightCache matrix_cache_disk(parametrisation_);
+
+        MatrixCacheCreator creator(*this, ctx, in, out, masks, cropping_);
+        cacheFile = matrix_cache_disk.getOrCreate(disk_key, creator, W);
+    }
+    else {
+        createMatrix(ctx, in, out, W, masks, cropping_);
+    }
+
+    // If LSM not cacheable to disk, because it is user provided
+    // it will be cached in memory nevertheless
+    if (masks.active() && !masks.cacheable()) {
+        applyMasks(W, masks);
+        W.validate("applyMasks", validateMatrixWeights());
+    }
+
+    if (!matrixReorder_.empty()) {
+        trace::Timer reordering("MethodWeighted::getMatrix reorder '" + matrixReorder_ + "'");
+        auto cacheUseReorder(ctx.statistics().cacheUser(MATRIX_REORDER_CACHE_MEMORY));
+        reorder_matrix(W, points_order(matrixReorder_, out), points_order(matrixReorder_, in));
+    }
+
+    return cacheFile;
+}
+
+
 // This returns a 'const' matrix so we ensure that we don't change it and break the in-memory cache
 const WeightMatrix& MethodWeighted::getMatrix(context::Context& ctx, const repres::Representation& in,
                                               const repres::Representation& out) const {
-    util::lock_guard<util::recursive_mutex> lock(MUTEX);
+    return getCachedMatrix(ctx, in, out).matrix;
+}
+
+
+const MethodWeighted::CachedMatrix& MethodWeighted::getCachedMatrix(context::Context& ctx,
+                                                                    const repres::Representation& in,
+                                                                    const repres::Representation& out) const {
     auto& log = Log::debug();
 
     log << "MethodWeighted::getMatrix " << *this << std::endl;
@@ -223,15 +458,29 @@ const WeightMatrix& MethodWeighted::getMatrix(context::Context& ctx, const repre
     log << "MethodWeighted::getMatrix land-sea masks: " << timer.elapsedSeconds(here) << ", "
         << (masks.active() ? "active" : "not active") << std::endl;
 
-    const auto [disk_key, memory_key] = getDiskAndMemoryCacheKeys(in, out, masks);
+    auto [disk_key, memory_key] = getDiskAndMemoryCacheKeys(in, out, masks);
     ASSERT(!disk_key.empty() && !memory_key.empty());
 
+    // reordered matrices are cached in memory only (disk cache is shared with the original ordering)
+    if (!matrixReorder_.empty()) {
+        memory_key += "-reorder-" + matrixReorder_;
+    }
+
+    if (auto* j = MATRIX_CACHE_MEMORY.find(memory_key); j != MATRIX_CACHE_MEMORY.end()) {
+        log << "MethodWeighted::getMatrix cache key: " << memory_key << " " << timer.elapsedSeconds(here)
+            << ", found in memory cache (" << j->matrix << ")" << std::endl;
+
+        return *j;
+    }
+
+    // single-flight: threads requiring the same matrix wait for the first one to create it, others are not blocked
+    util::KeyedMutex::Lock lock(MATRIX_MUTEX, memory_key);
+
     if (auto* j = MATRIX_CACHE_MEMORY.find(memory_key); j != MATRIX_CACHE_MEMORY.end()) {
-        const auto& mat = *j;
         log << "MethodWeighted::getMatrix cache key: " << memory_key << " " << timer.elapsedSeconds(here)
-            << ", found in memory cache (" << mat << ")" << std::endl;
+            << ", found in memory cache after waiting (" << j->matrix << ")" << std::endl;
 
-        return mat;
+        return *j;
     }
 
     log << "MethodWeighted::getMatrix cache key: " << memory_key << " " << timer.elapsedSeconds(here)
@@ -242,31 +491,46 @@ const WeightMatrix& MethodWeighted::getMatrix(context::Context& ctx, const repre
     here = timer.elapsed();
     WeightMatrix W(out.numberOfPoints(), in.numberOfPoints());
 
-    eckit::PathName cacheFile;
-
     bool caching = LibMir::caching();
     parametrisation_.get("caching", caching);
 
-    if (caching) {
-        // WeightCache is parametrised by 'caching' (it may be disabled for specific fields, eg. unstructured grids)
-        static caching::WeightCache matrix_cache_disk(parametrisation_);
+    const auto cacheFile = loadOrCreateMatrix(ctx, in, out, masks, disk_key, W);
 
-        MatrixCacheCreator creator(*this, ctx, in, out, masks, cropping_);
-        cacheFile = matrix_cache_disk.getOrCreate(disk_key, creator, W);
-    }
-    else {
-        createMatrix(ctx, in, out, W, masks, cropping_);
+    log << "MethodWeighted::getMatrix create weights matrix: " << timer.elapsedSeconds(here) << std::endl;
+    log << "MethodWeighted::getMatrix matrix W " << W << std::endl;
+
+    // structural metadata, kept as a sidecar to the disk cached matrix (if that is the matrix in use), identified by
+    // the cache key hash (a sidecar left over from another matrix, or in an older format, is recomputed)
+    WeightMatrixStructure S;
+    const bool sidecar = caching && !(masks.active() && !masks.cacheable()) && matrixReorder_.empty();
+    const auto digest  = eckit::MD5(disk_key).digest();
+
+    if (auto path = WeightMatrixStructure::sidecarPath(cacheFile);
+        sidecar && path.exists() && cacheFile.lastModified() <= path.lastModified()) {
+        try {
+            S.load(path);
+        }
+        catch (std::exception& e) {
+            Log::warning() << "MethodWeighted::getMatrix: cannot load matrix structure: " << e.what() << std::endl;
+        }
     }
 
-    // If LSM not cacheable to disk, because it is user provided
-    // it will be cached in memory nevertheless
-    if (masks.active() && !masks.cacheable()) {
-        applyMasks(W, masks);
-        W.validate("applyMasks", validateMatrixWeights());
+    if (!S.matches(W, digest)) {
+        WeightMatrixStructure tmp(W, digest);
+        S.swap(tmp);
+
+        if (sidecar) {
+            try {
+                S.save(WeightMatrixStructure::sidecarPath(cacheFile));
+            }
+            catch (std::exception& e) {
+                // not fatal, the disk cache can be read-only
+                Log::warning() << "MethodWeighted::getMatrix: cannot save matrix structure: " << e.what() << std::endl;
+            }
+        }
     }
 
-    log << "MethodWeighted::getMatrix create weights matrix: " << timer.elapsedSeconds(here) << std::endl;
-    log << "MethodWeighted::getMatrix matrix W " << W << std::endl;
+    log << "MethodWeighted::getMatrix matrix structure " << S << std::endl;
 
     if (!interpolationMatrix_.empty()) {
         log << "MethodWeighted::getMatrix link '" << cacheFile << "' to '" << interpolationMatrix_ << "'" << std::endl;
@@ -283,13 +547,18 @@ const WeightMatrix& MethodWeighted::getMatrix(context::Context& ctx, const repre
         ASSERT(anotherFile.exists());
     }
 
-    // insert matrix in the in-memory cache and update memory footprint
+    // insert matrix in the in-memory cache (complete, as it is visible to other threads) and update memory footprint
+
+    std::unique_ptr<CachedMatrix> entry(new CachedMatrix);
+    S.swap(entry->structure);
+    entry->key = memory_key;
 
-    WeightMatrix& w = MATRIX_CACHE_MEMORY[memory_key];
+    auto& w = entry->matrix;
     W.swap(w);
 
     size_t footprint = w.footprint();
-    caching::InMemoryCacheUsage usage(w.inSharedMemory() ? 0 : footprint, w.inSharedMemory() ? footprint : 0);
+    caching::InMemoryCacheUsage usage((w.inSharedMemory() ? 0 : footprint) + entry->structure.footprint(),
+                                      w.inSharedMemory() ? footprint : 0);
 
     log << "Matrix footprint " << w.owner() << " " << usage << " W -> " << W.owner() << std::endl;
 
@@ -318,7 +587,180 @@ const WeightMatrix& MethodWeighted::getMatrix(context::Context& ctx, const repre
         j.endObject();
     }
 
+    auto& cached = MATRIX_CACHE_MEMORY.insert(memory_key, entry.release());
     MATRIX_CACHE_MEMORY.footprint(memory_key, usage);
+    return cached;
+}
+
+
+bool MethodWeighted::solveAdjusted(const CachedMatrix& cached, DenseMatrix& A, DenseMatrix& B,
+                                   const MIRValuesVector& values, const double& missingValue, bool fused,
+                                   size_t threads) const {
+    auto& log = Log::debug();
+
+    const auto key = cached.key + "-missing-" + missing_mask_digest(nonLinear_, values, missingValue);
+    const auto& W  = cached.matrix;
+
+    const AdjustedMatrix* M = nullptr;
+    {
+        util::KeyedMutex::Lock lock(MATRIX_ADJUSTED_MUTEX, key);
+
+        auto& entry = MATRIX_ADJUSTED_CACHE_MEMORY[key];
+        if (entry.adjusted) {
+            log << "MethodWeighted::solveAdjusted cache key: " << key << ", found in memory cache" << std::endl;
+        }
+        else if (++entry.occurrences < 2 && fused) {
+            // on the first occurrence of a mask, only remember it (the fused multiplication does not need it)
+            MATRIX_ADJUSTED_CACHE_MEMORY.footprint(key, caching::InMemoryCacheUsage(entry.footprint() + key.size(), 0));
+            return false;
+        }
+        else {
+            trace::Timer timer("MethodWeighted::solveAdjusted");
+            log << "MethodWeighted::solveAdjusted cache key: " << key << ", not found in memory cache" << std::endl;
+
+            const auto* data  = W.data();
+            const auto* outer = W.outer();
+            const auto* inner = W.inner();
+
+            std::vector<WeightMatrix::Scalar> weights;  // row weights copy, reused
+            for (WeightMatrix::Size r = 0; r < W.rows(); ++r) {
+                const auto k = size_t(outer[r]);
+                const auto N = size_t(outer[r + 1]) - k;
+                if (N == 0) {
+                    continue;
+                }
+
+                weights.assign(data + k, data + k + N);
+                for (const auto& n : nonLinear_) {
+                    n->treatmentRow(weights.data(), inner + k, N, values, missingValue);
+                }
+
+                if (!std::equal(weights.begin(), weights.end(), data + k)) {
+                    entry.rows.push_back(r);
+                    entry.weights.insert(entry.weights.end(), weights.begin(), weights.end());
+                    entry.offsets.push_back(entry.weights.size());
+                }
+            }
+
+            entry.adjusted = true;
+            log << "MethodWeighted::solveAdjusted " << Log::Pretty(entry.rows.size(), {"row"}) << " adjusted"
+                << std::endl;
+
+            MATRIX_ADJUSTED_CACHE_MEMORY.footprint(key, caching::InMemoryCacheUsage(entry.footprint() + key.size(), 0));
+        }
+
+        M = &entry;
+    }
+
+    // (cache users prevent the entry from being purged)
+    if (fused) {
+        multiply_adjusted(W, *M, A, B, threads);
+        return true;
+    }
+
+    // other solvers use a matrix copy with the adjusted rows
+    WeightMatrix C(W);
+    auto* data        = const_cast<WeightMatrix::Scalar*>(C.data());
+    const auto* outer = C.outer();
+    for (size_t m = 0; m < M->rows.size(); ++m) {
+        std::copy(M->weights.begin() + long(M->offsets[m]), M->weights.begin() + long(M->offsets[m + 1]),
+                  data + outer[M->rows[m]]);
+    }
+
+    C.validate("solveAdjusted", validateMatrixWeights());
+    solver_->solve(A, C, B, missingValue);
+    return true;
+}
+
+
+const WeightMatrixSinglePrecision& MethodWeighted::getMatrixSinglePrecision(context::Context& ctx,
+                                                                             const repres::Representation& in,
+                                                                             const repres::Representation& out) const {
+    auto& log = Log::debug();
+
+    trace::Timer timer("MethodWeighted::getMatrixSinglePrecision");
+
+    const auto masks            = getMasks(in, out);
+    auto [disk_key, memory_key] = getDiskAndMemoryCacheKeys(in, out, masks);
+    ASSERT(!disk_key.empty() && !memory_key.empty());
+
+    // converted from the reordered matrix (see getMatrix)
+    const std::string double_disk_key = disk_key;
+    if (!matrixReorder_.empty()) {
+        disk_key += "-reorder-" + matrixReorder_;
+        memory_key += "-reorder-" + matrixReorder_;
+    }
+
+    if (auto* j = MATRIX_SINGLE_PRECISION_CACHE_MEMORY.find(memory_key);
+        j != MATRIX_SINGLE_PRECISION_CACHE_MEMORY.end()) {
+        log << "MethodWeighted::getMatrixSinglePrecision cache key: " << memory_key
+            << ", found in memory cache (" << *j << ")" << std::endl;
+        return *j;
+    }
+
+    // single-flight (see getMatrix)
+    util::KeyedMutex::Lock lock(MATRIX_SINGLE_PRECISION_MUTEX, memory_key);
+
+    if (auto* j = MATRIX_SINGLE_PRECISION_CACHE_MEMORY.find(memory_key);
+        j != MATRIX_SINGLE_PRECISION_CACHE_MEMORY.end()) {
+        return *j;
+    }
+
+    // convert from the (double precision) weights matrix: the one in memory if any (the memory cache keys are the
+    // same for both precisions), otherwise a temporary one loaded from (or created into) the double precision disk
+    // cache
+    const std::string double_key = memory_key;
+
+    const std::function<void(WeightMatrixSinglePrecision&)> convert = [&](WeightMatrixSinglePrecision& w) {
+        if (auto* j = MATRIX_CACHE_MEMORY.find(double_key); j != MATRIX_CACHE_MEMORY.end()) {
+            WeightMatrixSinglePrecision tmp(j->matrix);
+            w.swap(tmp);
+            return;
+        }
+
+        WeightMatrix D(out.numberOfPoints(), in.numberOfPoints());
+        loadOrCreateMatrix(ctx, in, out, masks, double_disk_key, D);
+
+        WeightMatrixSinglePrecision tmp(D);
+        w.swap(tmp);
+    };
+
+    WeightMatrixSinglePrecision W;
+
+    bool caching = LibMir::caching();
+    parametrisation_.get("caching", caching);
+
+    // user-provided land-sea masks are applied after the disk cache (see getMatrix)
+    if (caching && !(masks.active() && !masks.cacheable())) {
+        static caching::WeightCacheSinglePrecision matrix_cache_disk;
+
+        class CacheCreator final : public caching::WeightCacheSinglePrecision::CacheContentCreator {
+            const std::function<void(WeightMatrixSinglePrecision&)>& convert_;
+
+            void create(const eckit::PathName& /*path*/, WeightMatrixSinglePrecision& w, bool& /*saved*/) final {
+                convert_(w);
+            }
+
+        public:
+            explicit CacheCreator(const std::function<void(WeightMatrixSinglePrecision&)>& convert) :
+                convert_(convert) {}
+        };
+
+        CacheCreator creator(convert);
+        matrix_cache_disk.getOrCreate(disk_key, creator, W);
+    }
+    else {
+        convert(W);
+    }
+
+    log << "MethodWeighted::getMatrixSinglePrecision matrix W " << W << std::endl;
+
+    // insert matrix in the in-memory cache and update memory footprint
+    auto* entry = new WeightMatrixSinglePrecision;
+    W.swap(*entry);
+
+    auto& w = MATRIX_SINGLE_PRECISION_CACHE_MEMORY.insert(memory_key, entry);
+    MATRIX_SINGLE_PRECISION_CACHE_MEMORY.footprint(memory_key, caching::InMemoryCacheUsage(w.footprint(), 0));
     return w;
 }
 
@@ -392,10 +834,55 @@ WeightMatrix::Check MethodWeighted::validateMatrixWeights() const {
 
 void MethodWeighted::execute(context::Context& ctx, const repres::Representation& in,
                              const repres::Representation& out) const {
+    if (matrixReorder_.empty()) {
+        interpolate(ctx, in, out);
+        return;
+    }
+
+    // matrix rows/columns are reordered for locality (see getMatrix), so are input values and results
+    trace::Timer timer("MethodWeighted::execute reorder '" + matrixReorder_ + "'");
 
+    auto cacheUseReorder(ctx.statistics().cacheUser(MATRIX_REORDER_CACHE_MEMORY));
+    const auto& rows = points_order(matrixReorder_, out);
+    const auto& cols = points_order(matrixReorder_, in);
+
+    data::MIRField& field = ctx.field();
+
+    // permuted values are written to a buffer, swapped with the field values (so the buffer storage is reused)
+    MIRValuesVector buffer;
+
+    for (size_t i = 0; i < field.dimensions(); i++) {
+        const auto& values = field.values(i);
+        ASSERT(values.size() == cols.size());
+
+        buffer.resize(values.size());
+        for (size_t j = 0; j < cols.size(); ++j) {
+            buffer[cols[j]] = values[j];
+        }
+        field.update(buffer, i);
+    }
+
+    interpolate(ctx, in, out);
+
+    for (size_t i = 0; i < field.dimensions(); i++) {
+        const auto& values = field.values(i);
+        ASSERT(values.size() == rows.size());
+
+        buffer.resize(values.size());
+        for (size_t j = 0; j < rows.size(); ++j) {
+            buffer[j] = values[rows[j]];
+        }
+        field.update(buffer, i);
+    }
+}
+
+
+void MethodWeighted::interpolate(context::Context& ctx, const repres::Representation& in,
+                                 const repres::Representation& out) const {
 
     // Make sure another thread to no evict anything from the cache while we are using it
     auto cacheUse(ctx.statistics().cacheUser(MATRIX_CACHE_MEMORY));
+    auto cacheUseAdjusted(ctx.statistics().cacheUser(MATRIX_ADJUSTED_CACHE_MEMORY));
 
     static bool check_stats = eckit::Resource<bool>("mirCheckStats", false);
 
@@ -407,22 +894,6 @@ void MethodWeighted::execute(context::Context& ctx, const repres::Representation
     const size_t npts_inp = in.numberOfPoints();
     const size_t npts_out = out.numberOfPoints();
 
-    const WeightMatrix& W = getMatrix(ctx, in, out);
-    ASSERT(W.rows() == npts_out);
-    ASSERT(W.cols() == npts_inp);
-
-    std::vector<size_t> forceMissing;  // reserving size unnecessary (not the general case)
-    {
-        auto begin = W.begin(0);
-        auto end(begin);
-        for (size_t r = 0; r < W.rows(); r++) {
-            if (begin == (end = W.end(r))) {
-                forceMissing.push_back(r);
-            }
-            begin = end;
-        }
-    }
-
     // ensure unique missingValue on no input missing values
     data::MIRField& field = ctx.field();
     const bool hasMissing = field.hasMissing();
@@ -439,6 +910,92 @@ void MethodWeighted::execute(context::Context& ctx, const repres::Representation
                                         });
 
 
+    std::string space;
+    parametrisation_.get("vector-space", space);
+    const data::Space& sp = data::SpaceChooser::lookup(space);
+
+    // batch field dimensions (single matrix multiplication) if the matrix is the same for all of them
+    bool batch = false;
+    parametrisation_.get("interpolation-batch", batch);
+    batch = batch && !matrixCopy && !check_stats && field.dimensions() > 1;
+
+    const auto threads = util::parallel_num_threads(parametrisation_);
+
+    // single precision weights support linear interpolation only (no matrix modification), and 32-bit column indices
+    const bool singlePrecision = singlePrecision_ && !matrixCopy &&
+                                 dynamic_cast<const solver::Multiply*>(solver_.get()) != nullptr &&
+                                 WeightMatrixSinglePrecision::indexable(npts_inp);
+
+    if (singlePrecision_ && !singlePrecision) {
+        log << "MethodWeighted::execute: single precision weights not supported, using double precision" << std::endl;
+    }
+
+    if (singlePrecision) {
+        auto cacheUseSinglePrecision(ctx.statistics().cacheUser(MATRIX_SINGLE_PRECISION_CACHE_MEMORY));
+
+        const auto& W = getMatrixSinglePrecision(ctx, in, out);
+        ASSERT(W.rows() == npts_out);
+        ASSERT(W.cols() == npts_inp);
+
+        auto multiply = [&W, threads](const DenseMatrix& A, DenseMatrix& B) { W.multiply(A, B, threads); };
+        const auto& forceMissing = W.emptyRows();
+
+        if (batch) {
+            executeBatched(ctx, npts_inp, npts_out, sp, forceMissing, multiply);
+            return;
+        }
+
+        for (size_t i = 0; i < field.dimensions(); i++) {
+            std::ostringstream os;
+            os << "Interpolating field (" << Log::Pretty(npts_inp) << " -> " << Log::Pretty(npts_out)
+               << ", single precision)";
+            trace::Timer trace(os.str());
+
+            MIRValuesVector result(npts_out);  // field.update() takes ownership with std::swap()
+            DenseMatrix A;
+            DenseMatrix B;
+            setOperandMatricesFromVectors(B, A, result, field.values(i), missingValue, sp);
+
+            {
+                auto timing(ctx.statistics().matrixTimer());
+                W.multiply(A, B, threads);
+            }
+
+            setVectorFromOperandMatrix(B, result, missingValue, sp);
+
+            for (auto& r : forceMissing) {
+                result[r] = missingValue;
+            }
+            field.update(result, i, hasMissing || !forceMissing.empty());
+        }
+        return;
+    }
+
+
+    const auto& cached = getCachedMatrix(ctx, in, out);
+
+    const WeightMatrix& W = cached.matrix;
+    ASSERT(W.rows() == npts_out);
+    ASSERT(W.cols() == npts_inp);
+
+    // empty rows are computed once per matrix
+    const auto& forceMissing = cached.structure.emptyRows();
+
+    // rows of the same width (eg. k-nearest neighbours) allow a specialised row product
+    const auto rowNonZeros = forceMissing.empty() ? cached.structure.fixedRowNonZeros() : 0;
+
+    // linear solver supports non-linear treatments fused with the multiplication
+    const bool fused = dynamic_cast<const solver::Multiply*>(solver_.get()) != nullptr;
+
+    if (batch && solver_->multipleColumns()) {
+        executeBatched(ctx, npts_inp, npts_out, sp, forceMissing,
+                       [this, &W, missingValue](const DenseMatrix& A, DenseMatrix& B) {
+                           solver_->solve(A, W, B, missingValue);
+                       });
+        return;
+    }
+
+
     for (size_t i = 0; i < field.dimensions(); i++) {
 
         std::ostringstream os;
@@ -453,10 +1010,6 @@ void MethodWeighted::execute(context::Context& ctx, const repres::Representation
         }
 
         // Get input/output matrices
-        std::string space;
-        parametrisation_.get("vector-space", space);
-        const data::Space& sp = data::SpaceChooser::lookup(space);
-
         MIRValuesVector result(npts_out);  // field.update() takes ownership with std::swap()
         DenseMatrix A;
         DenseMatrix B;
@@ -467,19 +1020,12 @@ void MethodWeighted::execute(context::Context& ctx, const repres::Representation
 
         if (matrixCopy) {
             auto timing(ctx.statistics().matrixTimer());
-            WeightMatrix M(W);  // modifiable matrix copy
 
-            for (const auto& n : nonLinear_) {
-                std::ostringstream str;
-                str << *n;
-                trace::Timer t(str.str());
-
-                if (n->treatment(A, M, B, field.values(i), missingValue)) {
-                    M.validate(str.str().c_str(), validateMatrixWeights());
-                }
+            // matrix rows adjusted for the missing values mask, cached if the mask repeats; otherwise, non-linear
+            // treatments applied row by row during the multiplication (the matrix is not modified)
+            if (!solveAdjusted(cached, A, B, field.values(i), missingValue, fused, threads)) {
+                nonlinear::multiply(nonLinear_, W, A, B, field.values(i), missingValue, threads, rowNonZeros);
             }
-
-            solver_->solve(A, M, B, missingValue);
         }
         else {
             auto timing(ctx.statistics().matrixTimer());
@@ -506,6 +1052,69 @@ void MethodWeighted::execute(context::Context& ctx, const repres::Representation
 }
 
 
+void MethodWeighted::executeBatched(context::Context& ctx, size_t npts_inp, size_t npts_out, const data::Space& sp,
+                                    const std::vector<size_t>& forceMissing,
+                                    const std::function<void(const DenseMatrix&, DenseMatrix&)>& multiply) const {
+    data::MIRField& field     = ctx.field();
+    const bool hasMissing     = field.hasMissing();
+    const double missingValue = field.missingValue();
+
+    const size_t N = field.dimensions();
+    ASSERT(N > 0);
+
+    std::ostringstream os;
+    os << "Interpolating " << Log::Pretty(N, {"field"}) << " (" << Log::Pretty(npts_inp) << " -> "
+       << Log::Pretty(npts_out) << ")";
+    trace::Timer trace(os.str());
+
+    // set input matrix A (from B = W × A), a column block per field (matrices are column-major)
+    DenseMatrix A;
+    size_t C = 0;
+
+    for (size_t i = 0; i < N; i++) {
+        const auto& values = field.values(i);
+        ASSERT(values.size() == npts_inp);
+
+        // FIXME: remove const_cast once Matrix provides read-only view
+        DenseMatrix Awrap(const_cast<double*>(values.data()), npts_inp, 1);
+        DenseMatrix Ai;
+        sp.linearise(Awrap, Ai, missingValue);
+        ASSERT(Ai.rows() == npts_inp);
+
+        if (i == 0) {
+            C = Ai.cols();
+            ASSERT(C > 0);
+            A.resize(npts_inp, C * N);
+        }
+
+        ASSERT(Ai.cols() == C);
+        std::copy_n(Ai.data(), npts_inp * C, A.data() + i * npts_inp * C);
+    }
+
+    // set output matrix B (from B = W × A), and solve (single matrix multiplication)
+    DenseMatrix B(npts_out, C * N);
+    B.setZero();
+
+    {
+        auto timing(ctx.statistics().matrixTimer());
+        multiply(A, B);
+    }
+
+    // update field values with interpolation result, per column block
+    for (size_t i = 0; i < N; i++) {
+        DenseMatrix Bi(B.data() + i * npts_out * C, npts_out, C);
+
+        MIRValuesVector result(npts_out);  // field.update() takes ownership with std::swap()
+        setVectorFromOperandMatrix(Bi, result, missingValue, sp);
+
+        for (auto& r : forceMissing) {
+            result[r] = missingValue;
+        }
+        field.update(result, i, hasMissing || !forceMissing.empty());
+    }
+}
+
+
 void MethodWeighted::computeMatrixWeights(context::Context& ctx, const repres::Representation& in,
                                           const repres::Representation& out, WeightMatrix& W) const {
     auto timing(ctx.statistics().computeMatrixTimer());
@@ -524,27 +1133,15 @@ void MethodWeighted::computeMatrixWeights(context::Context& ctx, const repres::R
 
             auto rows =
                 std::unique_ptr<Reorder>(Reorder::build(reorderRows_.empty() ? "identity" : reorderRows_, W.rows()))
-                    ->reorder();
+                    ->reorder(out);
             ASSERT(rows.size() == out.numberOfPoints());
 
             auto cols =
                 std::unique_ptr<Reorder>(Reorder::build(reorderCols_.empty() ? "identity" : reorderCols_, W.cols()))
-                    ->reorder();
+                    ->reorder(in);
             ASSERT(cols.size() == in.numberOfPoints());
 
-            // expand triplets, renumbering directly
-            std::vector<eckit::linalg::Triplet> trips;
-            trips.reserve(W.nonZeros());
-
-            for (auto i = W.begin(), end = W.end(); i != end; ++i) {
-                trips.emplace_back(rows.at(i.row()), cols.at(i.col()), *i);
-            }
-
-            // compress triplets, replace matrix
-            std::sort(trips.begin(), trips.end());
-
-            eckit::linalg::SparseMatrix w(W.rows(), W.cols(), trips);
-            W.swap(w);
+            reorder_matrix(W, rows, cols);
         }
     }
 }
@@ -12,10 +12,13 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "eckit/filesystem/PathName.h"
 #include "eckit/linalg/Matrix.h"
 
 #include "mir/method/Cropping.h"
@@ -37,6 +40,7 @@ class NonLinear;
 namespace solver {
 class Solver;
 }
+class WeightMatrixSinglePrecision;
 }  // namespace method
 namespace repres {
 class Representation;
@@ -59,6 +63,9 @@ public:
 
     using CacheKeys = std::pair<std::string, std::string>;
 
+    /// Weights matrix and its structural metadata, as cached in memory (with its memory cache key)
+    struct CachedMatrix;
+
     // -- Constructors
 
     explicit MethodWeighted(const param::MIRParametrisation&);
@@ -84,6 +91,9 @@ public:
     const WeightMatrix& getMatrix(context::Context&, const repres::Representation& in,
                                   const repres::Representation& out) const;
 
+    const WeightMatrixSinglePrecision& getMatrixSinglePrecision(context::Context&, const repres::Representation& in,
+                                                                const repres::Representation& out) const;
+
 protected:
     // -- Methods
 
@@ -91,7 +101,7 @@ protected:
     void addNonLinearTreatment(const nonlinear::NonLinear*);
     void setSolver(const solver::Solver*);
     void setReorderRows(const std::string& name) { reorderRows_ = name; }
-    void setReorderCols(const std::string& name) { reorderRows_ = name; }
+    void setReorderCols(const std::string& name) { reorderCols_ = name; }
     double poleDisplacement() const { return poleDisplacement_; }
 
     // -- Overridden methods
@@ -113,9 +123,11 @@ private:
     std::unique_ptr<const solver::Solver> solver_;
     std::string reorderRows_;
     std::string reorderCols_;
+    std::string matrixReorder_;
     std::string interpolationMatrix_;
 
     bool matrixAssemble_;
+    bool singlePrecision_;
 
     // -- Methods
 
@@ -129,6 +141,21 @@ private:
     virtual lsm::LandSeaMasks getMasks(const repres::Representation& in, const repres::Representation& out) const;
     virtual WeightMatrix::Check validateMatrixWeights() const;
 
+    const CachedMatrix& getCachedMatrix(context::Context&, const repres::Representation& in,
+                                        const repres::Representation& out) const;
+
+    /// Weights matrix from the disk cache (created if not found), with user-provided masks applied and reordered;
+    /// returns the disk cache file (empty if not caching)
+    eckit::PathName loadOrCreateMatrix(context::Context&, const repres::Representation& in,
+                                       const repres::Representation& out, const lsm::LandSeaMasks&,
+                                       const std::string& disk_key, WeightMatrix&) const;
+
+    /// Solve with the matrix rows adjusted by the non-linear treatments for the input missing values mask, cached in
+    /// memory (modified rows only); with the fused multiplication these are built on the second occurrence of the mask
+    /// only (returns false on the first, nothing is solved)
+    bool solveAdjusted(const CachedMatrix&, DenseMatrix& A, DenseMatrix& B, const MIRValuesVector&,
+                       const double& missingValue, bool fused, size_t threads) const;
+
     void computeMatrixWeights(context::Context&, const repres::Representation& in, const repres::Representation& out,
                               WeightMatrix&) const;
     void createMatrix(context::Context&, const repres::Representation& in, const repres::Representation& out,
@@ -143,6 +170,14 @@ private:
     virtual void setVectorFromOperandMatrix(const DenseMatrix& A, MIRValuesVector& Avector, const double& missingValue,
                                             const data::Space&) const;
 
+    /// Interpolate all field dimensions, in matrix rows/columns order
+    void interpolate(context::Context&, const repres::Representation& in, const repres::Representation& out) const;
+
+    /// Interpolate all field dimensions with a single multiplication, operand column blocks per dimension
+    void executeBatched(context::Context&, size_t npts_inp, size_t npts_out, const data::Space&,
+                        const std::vector<size_t>& forceMissing,
+                        const std::function<void(const DenseMatrix&, DenseMatrix&)>& multiply) const;
+
     // -- Overridden methods
 
     // From Method
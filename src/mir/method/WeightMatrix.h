@@ -26,6 +26,7 @@ public:
     using Triplet = eckit::linalg::Triplet;
     using Scalar  = eckit::linalg::Scalar;
     using Size    = eckit::linalg::Size;
+    using Index   = eckit::linalg::Index;
 
     struct Check {
         bool duplicates = true;
@@ -0,0 +1,171 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/method/WeightMatrixBuilder.h"
+
+#include <limits>
+#include <ostream>
+#include <utility>
+
+#include "mir/util/Exceptions.h"
+
+
+namespace mir::method {
+
+
+namespace {
+
+
+class BuilderAllocator final : public WeightMatrix::Allocator {
+public:
+    using OuterIndex = WeightMatrixBuilder::OuterIndex;
+    using InnerIndex = WeightMatrixBuilder::InnerIndex;
+    using Scalar     = WeightMatrixBuilder::Scalar;
+    using Size       = WeightMatrixBuilder::Size;
+
+    BuilderAllocator(Size rows, Size cols, std::vector<OuterIndex>&& outer, std::vector<InnerIndex>&& inner,
+                     std::vector<Scalar>&& data) :
+        rows_(rows), cols_(cols), outer_(std::move(outer)), inner_(std::move(inner)), data_(std::move(data)) {
+        ASSERT(outer_.size() == rows_ + 1);
+        ASSERT(inner_.size() == data_.size());
+    }
+
+    WeightMatrix::Layout allocate(WeightMatrix::Shape& shape) override {
+        shape.size_ = data_.size();
+        shape.rows_ = rows_;
+        shape.cols_ = cols_;
+
+        WeightMatrix::Layout layout;
+        layout.data_  = data_.data();
+        layout.outer_ = outer_.data();
+        layout.inner_ = inner_.data();
+        return layout;
+    }
+
+    void deallocate(WeightMatrix::Layout /*unused*/, WeightMatrix::Shape /*unused*/) override {
+        // arrays are released with the allocator
+    }
+
+    bool inSharedMemory() const override { return false; }
+
+    void print(std::ostream& out) const override {
+        out << "WeightMatrixBuilder[rows=" << rows_ << ",cols=" << cols_ << ",nnz=" << data_.size() << "]";
+    }
+
+private:
+    const Size rows_;
+    const Size cols_;
+    std::vector<OuterIndex> outer_;
+    std::vector<InnerIndex> inner_;
+    std::vector<Scalar> data_;
+};
+
+
+}  // namespace
+
+
+WeightMatrixBuilder::WeightMatrixBuilder(Size rows, Size cols) : rows_(rows), cols_(cols), first_(0) {
+    ASSERT(rows_ > 0);
+    ASSERT(cols_ > 0);
+    ASSERT_MSG(cols_ <= Size(std::numeric_limits<InnerIndex>::max()),
+               "WeightMatrixBuilder: number of columns exceeds index type");
+}
+
+
+void WeightMatrixBuilder::reserve(size_t nonZeros) {
+    inner_.reserve(nonZeros);
+    data_.reserve(nonZeros);
+}
+
+
+void WeightMatrixBuilder::open(Size row) {
+    ASSERT(row < rows_);
+
+    if (outer_.empty()) {
+        first_ = row;
+        outer_.push_back(0);
+        return;
+    }
+
+    auto last = first_ + outer_.size() - 1;
+    ASSERT_MSG(last <= row, "WeightMatrixBuilder: rows should be appended in non-decreasing order");
+
+    for (; last < row; ++last) {
+        outer_.push_back(static_cast<OuterIndex>(data_.size()));
+    }
+}
+
+
+void WeightMatrixBuilder::add(Size row, Size col, Scalar value) {
+    ASSERT(col < cols_);
+
+    open(row);
+    inner_.push_back(static_cast<InnerIndex>(col));
+    data_.push_back(value);
+}
+
+
+void WeightMatrixBuilder::add(const std::vector<Triplet>& triplets) {
+    for (const auto& t : triplets) {
+        add(t.row(), t.col(), t.value());
+    }
+}
+
+
+void WeightMatrixBuilder::append(WeightMatrixBuilder&& other) {
+    ASSERT(rows_ == other.rows_);
+    ASSERT(cols_ == other.cols_);
+
+    if (other.outer_.empty()) {
+        return;
+    }
+
+    if (outer_.empty()) {
+        *this = std::move(other);
+        return;
+    }
+
+    reserve(nonZeros() + other.nonZeros());
+
+    const auto n = other.outer_.size();
+    for (size_t k = 0; k < n; ++k) {
+        const auto begin = size_t(other.outer_[k]);
+        const auto end   = k + 1 < n ? size_t(other.outer_[k + 1]) : other.data_.size();
+
+        open(other.first_ + k);
+        inner_.insert(inner_.end(), other.inner_.begin() + begin, other.inner_.begin() + end);
+        data_.insert(data_.end(), other.data_.begin() + begin, other.data_.begin() + end);
+    }
+
+    other = WeightMatrixBuilder(rows_, cols_);
+}
+
+
+void WeightMatrixBuilder::build(WeightMatrix& W) {
+    ASSERT_MSG(data_.size() <= size_t(std::numeric_limits<OuterIndex>::max()),
+               "WeightMatrixBuilder: number of non-zeros exceeds index type");
+
+    // complete row starts: rows before the first and after the last appended row are empty
+    const auto nnz = static_cast<OuterIndex>(data_.size());
+
+    outer_.insert(outer_.begin(), first_, 0);
+    outer_.resize(rows_ + 1, nnz);
+
+    // matrix takes over the arrays
+    WeightMatrix M(new BuilderAllocator(rows_, cols_, std::move(outer_), std::move(inner_), std::move(data_)));
+    W.swap(M);
+
+    *this = WeightMatrixBuilder(rows_, cols_);
+}
+
+
+}  // namespace mir::method
@@ -0,0 +1,93 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <type_traits>
+#include <vector>
+
+#include "mir/method/WeightMatrix.h"
+
+
+namespace mir::method {
+
+
+/**
+ * Streaming compressed row storage (CSR) construction: entries are appended in non-decreasing row order (rows can be
+ * skipped, columns are kept in insertion order) directly into the final arrays, which the matrix then takes over
+ * without copying. Builders filling consecutive row blocks (eg. one per thread) can be appended to each other in order.
+ */
+class WeightMatrixBuilder {
+public:
+    // -- Types
+
+    using Triplet = WeightMatrix::Triplet;
+    using Scalar  = WeightMatrix::Scalar;
+    using Size    = WeightMatrix::Size;
+
+    using OuterIndex = std::remove_pointer_t<decltype(WeightMatrix::Layout::outer_)>;
+    using InnerIndex = std::remove_pointer_t<decltype(WeightMatrix::Layout::inner_)>;
+
+    // -- Constructors
+
+    WeightMatrixBuilder(Size rows, Size cols);
+
+    WeightMatrixBuilder(const WeightMatrixBuilder&) = delete;
+    WeightMatrixBuilder(WeightMatrixBuilder&&)      = default;
+
+    // -- Destructor
+
+    ~WeightMatrixBuilder() = default;
+
+    // -- Operators
+
+    WeightMatrixBuilder& operator=(const WeightMatrixBuilder&) = delete;
+    WeightMatrixBuilder& operator=(WeightMatrixBuilder&&)      = default;
+
+    // -- Methods
+
+    Size rows() const { return rows_; }
+    Size cols() const { return cols_; }
+    size_t nonZeros() const { return data_.size(); }
+    bool empty() const { return data_.empty(); }
+
+    void reserve(size_t nonZeros);
+
+    /// Append entry, row should not precede the last appended row
+    void add(Size row, Size col, Scalar value);
+
+    /// Append entries (eg. a single row weights), in order
+    void add(const std::vector<Triplet>&);
+
+    /// Append a builder of the same shape, its rows should not precede the last appended row (other is left empty)
+    void append(WeightMatrixBuilder&& other);
+
+    /// Move entries into matrix, replacing its contents (builder is left empty)
+    void build(WeightMatrix&);
+
+private:
+    // -- Members
+
+    Size rows_;
+    Size cols_;
+    Size first_;
+    std::vector<OuterIndex> outer_;  // row starts, from row first_ to last appended row
+    std::vector<InnerIndex> inner_;
+    std::vector<Scalar> data_;
+
+    // -- Methods
+
+    void open(Size row);
+};
+
+
+}  // namespace mir::method
@@ -0,0 +1,196 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/method/WeightMatrixSinglePrecision.h"
+
+#include <limits>
+#include <memory>
+#include <ostream>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/AutoCloser.h"
+#include "eckit/io/DataHandle.h"
+
+#include "mir/method/WeightMatrix.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Log.h"
+#include "mir/util/Parallel.h"
+#include "mir/util/Trace.h"
+
+
+namespace mir::method {
+
+
+namespace {
+
+
+constexpr std::uint64_t MAGIC = 0x4d49525733324353;  // "MIRW32CS"
+
+
+template <typename T>
+void write(eckit::DataHandle& h, const T* data, size_t n) {
+    const auto len = long(n * sizeof(T));
+    ASSERT(h.write(data, len) == len);
+}
+
+
+template <typename T>
+void read(eckit::DataHandle& h, T* data, size_t n) {
+    const auto len = long(n * sizeof(T));
+    ASSERT(h.read(data, len) == len);
+}
+
+
+}  // namespace
+
+
+WeightMatrixSinglePrecision::WeightMatrixSinglePrecision(const WeightMatrix& W) :
+    rows_(W.rows()), cols_(W.cols()) {
+    ASSERT_MSG(indexable(W.cols()), "WeightMatrixSinglePrecision: number of columns requires 64-bit indices");
+
+    outer_.resize(rows_ + 1);
+    inner_.reserve(W.nonZeros());
+    data_.reserve(W.nonZeros());
+
+    outer_[0] = 0;
+    for (WeightMatrix::Size r = 0; r < W.rows(); ++r) {
+        for (auto it = W.begin(r); it != W.end(r); ++it) {
+            inner_.push_back(static_cast<Index>(it.col()));
+            data_.push_back(static_cast<Scalar>(*it));
+        }
+        outer_[r + 1] = inner_.size();
+    }
+
+    ASSERT(data_.size() == W.nonZeros());
+    setEmptyRows();
+}
+
+
+bool WeightMatrixSinglePrecision::indexable(size_t cols) {
+    return cols <= std::numeric_limits<Index>::max();
+}
+
+
+size_t WeightMatrixSinglePrecision::footprint() const {
+    return sizeof(*this) + outer_.capacity() * sizeof(Size) + inner_.capacity() * sizeof(Index) +
+           data_.capacity() * sizeof(Scalar) + emptyRows_.capacity() * sizeof(size_t);
+}
+
+
+void WeightMatrixSinglePrecision::swap(WeightMatrixSinglePrecision& other) {
+    std::swap(rows_, other.rows_);
+    std::swap(cols_, other.cols_);
+    outer_.swap(other.outer_);
+    inner_.swap(other.inner_);
+    data_.swap(other.data_);
+    emptyRows_.swap(other.emptyRows_);
+}
+
+
+void WeightMatrixSinglePrecision::save(const eckit::PathName& path) const {
+    trace::Timer timer("WeightMatrixSinglePrecision: saving '" + path.asString() + "'");
+
+    std::unique_ptr<eckit::DataHandle> h(path.fileHandle());
+    h->openForWrite(0);
+    auto c = eckit::closer(*h);
+
+    const Size header[]{MAGIC, rows_, cols_, Size(data_.size())};
+    write(*h, header, 4);
+
+    ASSERT(outer_.size() == rows_ + 1);
+    write(*h, outer_.data(), outer_.size());
+    write(*h, inner_.data(), inner_.size());
+    write(*h, data_.data(), data_.size());
+}
+
+
+void WeightMatrixSinglePrecision::load(const eckit::PathName& path) {
+    trace::Timer timer("WeightMatrixSinglePrecision: loading '" + path.asString() + "'");
+
+    std::unique_ptr<eckit::DataHandle> h(path.fileHandle());
+    h->openForRead();
+    auto c = eckit::closer(*h);
+
+    Size header[4];
+    read(*h, header, 4);
+
+    if (header[0] != MAGIC) {
+        throw exception::SeriousBug("WeightMatrixSinglePrecision: bad magic in '" + path.asString() + "'");
+    }
+
+    WeightMatrixSinglePrecision tmp;
+    tmp.rows_ = header[1];
+    tmp.cols_ = header[2];
+
+    tmp.outer_.resize(tmp.rows_ + 1);
+    tmp.inner_.resize(header[3]);
+    tmp.data_.resize(header[3]);
+
+    read(*h, tmp.outer_.data(), tmp.outer_.size());
+    read(*h, tmp.inner_.data(), tmp.inner_.size());
+    read(*h, tmp.data_.data(), tmp.data_.size());
+
+    ASSERT(tmp.outer_.front() == 0 && tmp.outer_.back() == tmp.data_.size());
+    tmp.setEmptyRows();
+    swap(tmp);
+}
+
+
+void WeightMatrixSinglePrecision::setEmptyRows() {
+    emptyRows_.clear();
+    for (size_t r = 0; r < rows_; ++r) {
+        if (outer_[r] == outer_[r + 1]) {
+            emptyRows_.push_back(r);
+        }
+    }
+}
+
+
+void WeightMatrixSinglePrecision::multiply(const DenseMatrix& A, DenseMatrix& B, size_t threads) const {
+    ASSERT(A.rows() == cols_);
+    ASSERT(B.rows() == rows_);
+    ASSERT(A.cols() == B.cols());
+
+    const auto N   = size_t(A.cols());
+    const auto* a  = A.data();
+    auto* b        = B.data();
+    const auto lda = size_t(A.rows());
+    const auto ldb = size_t(B.rows());
+
+    // row-major traversal, matrix entries are read once for all operand columns (blocks of rows are independent)
+    util::parallel_for_blocks(rows_, threads, [&](size_t /*block*/, size_t rbegin, size_t rend) {
+        for (size_t r = rbegin; r < rend; ++r) {
+            const auto begin = outer_[r];
+            const auto end   = outer_[r + 1];
+
+            for (size_t j = 0; j < N; ++j) {
+                const auto* aj = a + j * lda;
+
+                double sum = 0.;
+                for (auto k = begin; k < end; ++k) {
+                    sum += static_cast<double>(data_[k]) * aj[inner_[k]];
+                }
+
+                b[r + j * ldb] = sum;
+            }
+        }
+    });
+}
+
+
+void WeightMatrixSinglePrecision::print(std::ostream& out) const {
+    out << "WeightMatrixSinglePrecision[rows=" << rows_ << ",cols=" << cols_ << ",nnz=" << data_.size()
+        << ",footprint=" << Log::Bytes(footprint()) << "]";
+}
+
+
+}  // namespace mir::method
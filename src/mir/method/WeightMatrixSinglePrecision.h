@@ -0,0 +1,114 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include "eckit/linalg/Matrix.h"
+
+
+namespace eckit {
+class PathName;
+}
+
+namespace mir::method {
+class WeightMatrix;
+}
+
+
+namespace mir::method {
+
+
+/**
+ * Compressed row storage (CSR) interpolation weights, in single precision (float32 weights and 32-bit column indices)
+ * to reduce memory footprint and bandwidth. Multiplication accumulates in double precision.
+ */
+class WeightMatrixSinglePrecision {
+public:
+    // -- Types
+
+    using Scalar      = float;
+    using Index       = std::uint32_t;
+    using Size        = std::uint64_t;
+    using DenseMatrix = eckit::linalg::Matrix;
+
+    // -- Constructors
+
+    WeightMatrixSinglePrecision() = default;
+
+    explicit WeightMatrixSinglePrecision(const WeightMatrix&);
+
+    WeightMatrixSinglePrecision(const WeightMatrixSinglePrecision&) = delete;
+    WeightMatrixSinglePrecision(WeightMatrixSinglePrecision&&)      = delete;
+
+    // -- Destructor
+
+    ~WeightMatrixSinglePrecision() = default;
+
+    // -- Operators
+
+    void operator=(const WeightMatrixSinglePrecision&) = delete;
+    void operator=(WeightMatrixSinglePrecision&&)      = delete;
+
+    // -- Methods
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t nonZeros() const { return data_.size(); }
+
+    size_t footprint() const;
+    bool inSharedMemory() const { return false; }
+
+    void swap(WeightMatrixSinglePrecision&);
+
+    void save(const eckit::PathName&) const;
+    void load(const eckit::PathName&);
+
+    /// Rows without entries (computed once)
+    const std::vector<size_t>& emptyRows() const { return emptyRows_; }
+
+    /// If a matrix with this number of columns can be represented (32-bit column indices)
+    static bool indexable(size_t cols);
+
+    /// B = W A (dense matrices in column-major order, any number of columns), accumulating in double precision, over
+    /// (at most) threads blocks of rows
+    void multiply(const DenseMatrix& A, DenseMatrix& B, size_t threads = 1) const;
+
+private:
+    // -- Members
+
+    Size rows_ = 0;
+    Size cols_ = 0;
+    std::vector<Size> outer_;
+    std::vector<Index> inner_;
+    std::vector<Scalar> data_;
+    std::vector<size_t> emptyRows_;
+
+    // -- Methods
+
+    void setEmptyRows();
+
+    void print(std::ostream&) const;
+
+    // -- Friends
+
+    friend std::ostream& operator<<(std::ostream& out, const WeightMatrixSinglePrecision& m) {
+        m.print(out);
+        return out;
+    }
+};
+
+
+}  // namespace mir::method
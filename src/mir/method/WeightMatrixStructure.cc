@@ -0,0 +1,149 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/method/WeightMatrixStructure.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <ostream>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/AutoCloser.h"
+#include "eckit/io/DataHandle.h"
+
+#include "mir/method/WeightMatrix.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Log.h"
+
+
+namespace mir::method {
+
+
+namespace {
+
+
+constexpr std::uint64_t MAGIC = 0x4d49525753545232;  // "MIRWSTR2"
+
+
+}  // namespace
+
+
+WeightMatrixStructure::WeightMatrixStructure(const WeightMatrix& W, const std::string& digest) :
+    rows_(W.rows()), nonZeros_(W.nonZeros()), digest_(digest) {
+    minRowNonZeros_ = std::numeric_limits<size_t>::max();
+
+    const auto* outer = W.outer();
+    for (size_t r = 0; r < rows_; ++r) {
+        if (auto n = static_cast<size_t>(outer[r + 1] - outer[r]); n == 0) {
+            emptyRows_.push_back(r);
+        }
+        else {
+            minRowNonZeros_ = std::min(minRowNonZeros_, n);
+            maxRowNonZeros_ = std::max(maxRowNonZeros_, n);
+        }
+    }
+
+    if (maxRowNonZeros_ == 0) {
+        minRowNonZeros_ = 0;
+    }
+}
+
+
+bool WeightMatrixStructure::matches(const WeightMatrix& W, const std::string& digest) const {
+    return rows_ == W.rows() && nonZeros_ == W.nonZeros() && digest_ == digest;
+}
+
+
+size_t WeightMatrixStructure::footprint() const {
+    return sizeof(*this) + emptyRows_.capacity() * sizeof(size_t) + digest_.capacity();
+}
+
+
+void WeightMatrixStructure::swap(WeightMatrixStructure& other) {
+    std::swap(rows_, other.rows_);
+    std::swap(nonZeros_, other.nonZeros_);
+    std::swap(minRowNonZeros_, other.minRowNonZeros_);
+    std::swap(maxRowNonZeros_, other.maxRowNonZeros_);
+    emptyRows_.swap(other.emptyRows_);
+    digest_.swap(other.digest_);
+}
+
+
+void WeightMatrixStructure::save(const eckit::PathName& path) const {
+    // write to a unique file, then rename (atomic) so concurrent readers only ever see a complete file
+    auto tmp = eckit::PathName::unique(path);
+    {
+        std::unique_ptr<eckit::DataHandle> h(tmp.fileHandle());
+        h->openForWrite(0);
+        auto c = eckit::closer(*h);
+
+        const std::uint64_t header[]{
+            MAGIC, rows_, nonZeros_, minRowNonZeros_, maxRowNonZeros_, emptyRows_.size(), digest_.size(),
+        };
+        ASSERT(h->write(header, long(sizeof(header))) == long(sizeof(header)));
+
+        ASSERT(h->write(digest_.data(), long(digest_.size())) == long(digest_.size()));
+
+        std::vector<std::uint64_t> empty(emptyRows_.begin(), emptyRows_.end());
+        const auto len = long(empty.size() * sizeof(std::uint64_t));
+        ASSERT(h->write(empty.data(), len) == len);
+    }
+
+    eckit::PathName::rename(tmp, path);
+}
+
+
+void WeightMatrixStructure::load(const eckit::PathName& path) {
+    std::unique_ptr<eckit::DataHandle> h(path.fileHandle());
+    h->openForRead();
+    auto c = eckit::closer(*h);
+
+    std::uint64_t header[7];
+    ASSERT(h->read(header, long(sizeof(header))) == long(sizeof(header)));
+
+    if (header[0] != MAGIC) {
+        throw exception::SeriousBug("WeightMatrixStructure: bad magic in '" + path.asString() + "'");
+    }
+
+    std::string digest(header[6], '\0');
+    ASSERT(h->read(digest.data(), long(digest.size())) == long(digest.size()));
+
+    std::vector<std::uint64_t> empty(header[5]);
+    const auto len = long(empty.size() * sizeof(std::uint64_t));
+    ASSERT(h->read(empty.data(), len) == len);
+
+    WeightMatrixStructure tmp;
+    tmp.rows_           = header[1];
+    tmp.nonZeros_       = header[2];
+    tmp.minRowNonZeros_ = header[3];
+    tmp.maxRowNonZeros_ = header[4];
+    tmp.emptyRows_.assign(empty.begin(), empty.end());
+    tmp.digest_.swap(digest);
+
+    swap(tmp);
+}
+
+
+eckit::PathName WeightMatrixStructure::sidecarPath(const eckit::PathName& path) {
+    return path + ".structure";
+}
+
+
+void WeightMatrixStructure::print(std::ostream& out) const {
+    out << "WeightMatrixStructure[rows=" << rows_ << ",nnz=" << nonZeros_ << ",emptyRows=" << emptyRows_.size()
+        << ",rowNonZeros=[" << minRowNonZeros_ << "," << maxRowNonZeros_ << "]]";
+}
+
+
+}  // namespace mir::method
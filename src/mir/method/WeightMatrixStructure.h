@@ -0,0 +1,110 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+
+namespace eckit {
+class PathName;
+}
+
+namespace mir::method {
+class WeightMatrix;
+}
+
+
+namespace mir::method {
+
+
+/**
+ * Structural metadata of interpolation weights: empty rows (forced to missing values) and non-zeros per row
+ * statistics, computed once per matrix and kept alongside it (in memory, and as a sidecar file to the disk cache).
+ */
+class WeightMatrixStructure {
+public:
+    // -- Constructors
+
+    WeightMatrixStructure() = default;
+
+    /// @param digest identifies the matrix (eg. its cache key hash), checked when loading from a sidecar file
+    explicit WeightMatrixStructure(const WeightMatrix&, const std::string& digest = "");
+
+    WeightMatrixStructure(const WeightMatrixStructure&) = delete;
+    WeightMatrixStructure(WeightMatrixStructure&&)      = delete;
+
+    // -- Destructor
+
+    ~WeightMatrixStructure() = default;
+
+    // -- Operators
+
+    void operator=(const WeightMatrixStructure&) = delete;
+    void operator=(WeightMatrixStructure&&)      = delete;
+
+    // -- Methods
+
+    size_t rows() const { return rows_; }
+    size_t nonZeros() const { return nonZeros_; }
+
+    /// Rows without entries
+    const std::vector<size_t>& emptyRows() const { return emptyRows_; }
+
+    /// Minimum/maximum number of entries of non-empty rows
+    size_t minRowNonZeros() const { return minRowNonZeros_; }
+    size_t maxRowNonZeros() const { return maxRowNonZeros_; }
+
+    /// Number of entries of all non-empty rows, if the same (eg. k-nearest neighbours), otherwise 0
+    size_t fixedRowNonZeros() const { return minRowNonZeros_ == maxRowNonZeros_ ? maxRowNonZeros_ : 0; }
+
+    const std::string& digest() const { return digest_; }
+
+    /// Matches matrix shape and identification
+    bool matches(const WeightMatrix&, const std::string& digest = "") const;
+
+    size_t footprint() const;
+
+    void swap(WeightMatrixStructure&);
+
+    void save(const eckit::PathName&) const;
+    void load(const eckit::PathName&);
+
+    /// Sidecar file to a (disk cached) matrix file
+    static eckit::PathName sidecarPath(const eckit::PathName&);
+
+private:
+    // -- Members
+
+    size_t rows_           = 0;
+    size_t nonZeros_       = 0;
+    size_t minRowNonZeros_ = 0;
+    size_t maxRowNonZeros_ = 0;
+    std::vector<size_t> emptyRows_;
+    std::string digest_;
+
+    // -- Methods
+
+    void print(std::ostream&) const;
+
+    // -- Friends
+
+    friend std::ostream& operator<<(std::ostream& out, const WeightMatrixStructure& s) {
+        s.print(out);
+        return out;
+    }
+};
+
+
+}  // namespace mir::method
@@ -13,12 +13,13 @@
 #include "mir/method/fe/FiniteElement.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
-#include <forward_list>
 #include <limits>
 #include <memory>
 #include <ostream>
 #include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -26,12 +27,14 @@
 #include "eckit/utils/MD5.h"
 
 #include "mir/caching/InMemoryMeshCache.h"
+#include "mir/method/WeightMatrixBuilder.h"
 #include "mir/param/MIRParametrisation.h"
 #include "mir/repres/Iterator.h"
 #include "mir/repres/Representation.h"
 #include "mir/util/Domain.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
+#include "mir/util/Parallel.h"
 #include "mir/util/Point2ToPoint3.h"
 #include "mir/util/Reorder.h"
 #include "mir/util/Trace.h"
@@ -77,28 +80,19 @@ using element_tree_t      = atlas::interpolation::method::ElemIndex3;
 using failed_projection_t = std::pair<size_t, PointLatLon>;
 
 
-struct element_t : std::vector<size_t> {
-    using vector::vector;
+/// Element vertex indices and weights (linear Lagrange functions at barycentric coordinates u,v), on the stack
+template <size_t N>
+struct element_t {
+    explicit element_t(const std::array<size_t, N>& _idx) : idx(_idx) {}
 
-    element_t(const element_t&)            = delete;
-    element_t(element_t&&)                 = delete;
-    element_t& operator=(const element_t&) = delete;
-    element_t& operator=(element_t&&)      = delete;
-
-    virtual ~element_t() = default;
-
-    virtual bool intersects(const atlas::interpolation::method::Ray&, double eps) = 0;
-
-    void append_triplets(size_t i, size_t nbRealPoints, std::vector<WeightMatrix::Triplet>& t) const {
-        ASSERT(size() == weights.size());
-
-        bool normalise = std::any_of(cbegin(), cend(), [nbRealPoints](size_t i) { return i >= nbRealPoints; });
+    void add_weights(size_t i, size_t nbRealPoints, WeightMatrixBuilder& W) const {
+        bool normalise = std::any_of(idx.cbegin(), idx.cend(), [nbRealPoints](size_t i) { return i >= nbRealPoints; });
         if (normalise) {
             // sum all calculated weights for normalisation
             double sum = 0.;
             size_t n   = 0;
-            for (size_t j = 0; j < size(); ++j) {
-                if (operator[](j) < nbRealPoints) {
+            for (size_t j = 0; j < N; ++j) {
+                if (idx[j] < nbRealPoints) {
                     sum += weights[j];
                     ++n;
                 }
@@ -109,9 +103,9 @@ struct element_t : std::vector<size_t> {
                 bool equitable = sum <= std::numeric_limits<double>::epsilon();
                 auto invSum    = 1. / (equitable ? static_cast<double>(n) : sum);
 
-                for (size_t j = 0; j < size() && 0 < n; ++j) {
-                    if (operator[](j) < nbRealPoints) {
-                        t.emplace_back(i, operator[](j), equitable ? invSum : (weights[j] * invSum));
+                for (size_t j = 0; j < N && 0 < n; ++j) {
+                    if (idx[j] < nbRealPoints) {
+                        W.add(i, idx[j], equitable ? invSum : (weights[j] * invSum));
                     }
                 }
             }
@@ -119,27 +113,27 @@ struct element_t : std::vector<size_t> {
             return;
         }
 
-        for (size_t j = 0; j < size(); ++j) {
-            t.emplace_back(i, operator[](j), weights[j]);
+        for (size_t j = 0; j < N; ++j) {
+            W.add(i, idx[j], weights[j]);
         }
     }
 
-    std::vector<double>
-        weights;  //< weights (per element vertex) are the linear Lagrange function at u,v (barycentric coordinates)
+    const std::array<size_t, N> idx;
+    std::array<double, N> weights{};
 };
 
 
-struct triag_t : element_t, atlas::interpolation::element::Triag3D {
+struct triag_t : element_t<3>, atlas::interpolation::element::Triag3D {
     triag_t(const atlas::array::ArrayView<double, 2>& coords, size_t i1, size_t i2, size_t i3) :
-        element_t{i1, i2, i3},
+        element_t<3>({i1, i2, i3}),
         Triag3D(atlas::PointXYZ{coords(i1, XYZCOORDS::XX), coords(i1, XYZCOORDS::YY), coords(i1, XYZCOORDS::ZZ)},
                 atlas::PointXYZ{coords(i2, XYZCOORDS::XX), coords(i2, XYZCOORDS::YY), coords(i2, XYZCOORDS::ZZ)},
                 atlas::PointXYZ{coords(i3, XYZCOORDS::XX), coords(i3, XYZCOORDS::YY), coords(i3, XYZCOORDS::ZZ)}) {}
 
-    bool intersects(const atlas::interpolation::method::Ray& r, double eps) override {
+    bool intersects(const atlas::interpolation::method::Ray& r, double eps) {
         auto is = Triag3D::intersects(r, eps * std::sqrt(area()));
         if (is) {
-            weights.assign({1. - is.u - is.v, is.u, is.v});
+            weights = {1. - is.u - is.v, is.u, is.v};
             return true;
         }
         return false;
@@ -147,18 +141,18 @@ struct triag_t : element_t, atlas::interpolation::element::Triag3D {
 };
 
 
-struct quad_t : element_t, atlas::interpolation::element::Quad3D {
+struct quad_t : element_t<4>, atlas::interpolation::element::Quad3D {
     quad_t(const atlas::array::ArrayView<double, 2>& coords, size_t i1, size_t i2, size_t i3, size_t i4) :
-        element_t{i1, i2, i3, i4},
+        element_t<4>({i1, i2, i3, i4}),
         Quad3D(atlas::PointXYZ{coords(i1, XYZCOORDS::XX), coords(i1, XYZCOORDS::YY), coords(i1, XYZCOORDS::ZZ)},
                atlas::PointXYZ{coords(i2, XYZCOORDS::XX), coords(i2, XYZCOORDS::YY), coords(i2, XYZCOORDS::ZZ)},
                atlas::PointXYZ{coords(i3, XYZCOORDS::XX), coords(i3, XYZCOORDS::YY), coords(i3, XYZCOORDS::ZZ)},
                atlas::PointXYZ{coords(i4, XYZCOORDS::XX), coords(i4, XYZCOORDS::YY), coords(i4, XYZCOORDS::ZZ)}) {}
 
-    bool intersects(const atlas::interpolation::method::Ray& r, double eps) override {
+    bool intersects(const atlas::interpolation::method::Ray& r, double eps) {
         auto is = Quad3D::intersects(r, eps * std::sqrt(area()));
         if (is) {
-            weights.assign({(1. - is.u) * (1. - is.v), is.u * (1. - is.v), is.u * is.v, (1. - is.u) * is.v});
+            weights = {(1. - is.u) * (1. - is.v), is.u * (1. - is.v), is.u * is.v, (1. - is.u) * is.v};
             return true;
         }
         return false;
@@ -169,6 +163,17 @@ struct quad_t : element_t, atlas::interpolation::element::Quad3D {
 }  // namespace
 
 
+FiniteElement::ProjectionStatistics& FiniteElement::ProjectionStatistics::operator+=(
+    const ProjectionStatistics& other) {
+    nbMaxElementsSearched   = std::max(nbMaxElementsSearched, other.nbMaxElementsSearched);
+    nbMinElementsSearched   = std::min(nbMinElementsSearched, other.nbMinElementsSearched);
+    nbMaxProjectionAttempts = std::max(nbMaxProjectionAttempts, other.nbMaxProjectionAttempts);
+    nbProjections += other.nbProjections;
+    failures.insert(failures.end(), other.failures.begin(), other.failures.end());
+    return *this;
+}
+
+
 FiniteElement::FiniteElement(const param::MIRParametrisation& param) :
     MethodWeighted(param), meshGeneratorParams_(param) {
     param.get("finite-element-validate-mesh", validateMesh_ = false);
@@ -299,6 +304,44 @@ void FiniteElement::assemble(util::MIRStatistics& statistics, WeightMatrix& W, c
                              const repres::Representation& out) const {
     auto& log = Log::debug();
 
+    ProjectionStatistics stats;
+    assemble(statistics, W, in, out, stats);
+
+    if (const auto nbFailures = stats.failures.size(); nbFailures > 0) {
+        std::ostringstream msg;
+        msg << "Failed to project " << Log::Pretty(nbFailures, {"point"});
+        log << msg.str() << ":";
+
+        // report (some) failed points
+        auto failed = stats.failures;
+        std::sort(failed.begin(), failed.end());
+
+        std::vector<failed_projection_t> failures;
+        for (const std::unique_ptr<repres::Iterator> it(out.iterator());
+             failures.size() <= nbMaxFailures && it->next();) {
+            if (auto ip = it->index(); std::binary_search(failed.begin(), failed.end(), ip)) {
+                failures.emplace_back(ip, it->pointUnrotated());
+            }
+        }
+
+        size_t count = 0;
+        for (const auto& f : failures) {
+            log << "\n\tpoint " << f.first << " " << f.second;
+            if (++count > nbMaxFailures) {
+                log << "\n\t...";
+                break;
+            }
+        }
+        log << std::endl;
+        throw exception::SeriousBug(msg.str());
+    }
+}
+
+
+void FiniteElement::assemble(util::MIRStatistics& statistics, WeightMatrix& W, const repres::Representation& in,
+                             const repres::Representation& out, ProjectionStatistics& stats) const {
+    auto& log = Log::debug();
+
     log << "FiniteElement::assemble (input: " << in << ", output: " << out << ")" << std::endl;
 
 
@@ -332,116 +375,141 @@ void FiniteElement::assemble(util::MIRStatistics& statistics, WeightMatrix& W, c
 
     util::Point2ToPoint3 point3(out, poleDisplacement());
 
-    // some statistics
-    size_t nbMaxElementsSearched   = 0;
-    size_t nbMinElementsSearched   = std::numeric_limits<size_t>::max();
-    size_t nbMaxProjectionAttempts = 0;
-    size_t nbProjections           = 0;
-    size_t nbFailures              = 0;
+    // project output point (3D) on the elements closest to it, in order
+    auto project = [&](size_t ip, const Point3& p, WeightMatrixBuilder& builder, ProjectionStatistics& stats) {
+        size_t nbProjectionAttempts = 0;
+
+        auto closest = eTree->findInSphere(p, R);
+
+        atlas::interpolation::method::Ray ray(p.data());
+
+        // epsilon used to scale edge tolerance when projecting ray to intersect elements
+        // (if it fails consider increasing eps, or use ProjectionFail::increaseEpsilon)
+        double eps = 1e-15;
+
+        bool success = false;
+        for (size_t a = 0;
+             a == 0 || (!success && a < nbMaxFailures && projectionFail_ == ProjectionFail::increaseEpsilon);
+             eps *= 2., ++a) {
+            for (const auto& close : closest) {
+                ++nbProjectionAttempts;
+
+                /*
+                 * Assumes:
+                 * - nb_cols == 3 implies triangle
+                 * - nb_cols == 4 implies quadrilateral
+                 * - no other element is supported at the time
+                 */
+                const auto e = static_cast<atlas::idx_t>(close.value().payload());
+                ASSERT(e < connectivity.rows());
+
+                auto idx = [e, nbInputPoints, &connectivity](atlas::idx_t j) {
+                    auto x = static_cast<size_t>(connectivity(e, j));
+                    ASSERT(x < nbInputPoints);
+                    return x;
+                };
+
+                if (const auto nb_cols = connectivity.cols(e); nb_cols == 3) {
+                    if (triag_t elem(inCoords, idx(0), idx(1), idx(2)); elem.intersects(ray, eps)) {
+                        elem.add_weights(ip, nbRealPts, builder);
+                        success = true;
+                        break;
+                    }
+                }
+                else if (nb_cols == 4) {
+                    if (quad_t elem(inCoords, idx(0), idx(1), idx(2), idx(3)); elem.intersects(ray, eps)) {
+                        elem.add_weights(ip, nbRealPts, builder);
+                        success = true;
+                        break;
+                    }
+                }
+                else {
+                    NOTIMP;
+                }
+            }
+        }
 
-    std::forward_list<failed_projection_t> failures;
-    std::vector<WeightMatrix::Triplet> weights_triplets;  // structure to fill-in sparse matrix
-    weights_triplets.reserve(nbOutputPoints * 4);         // preallocate space as if all elements where quads
+        stats.nbMaxElementsSearched   = std::max(stats.nbMaxElementsSearched, closest.size());
+        stats.nbMinElementsSearched   = std::min(stats.nbMinElementsSearched, closest.size());
+        stats.nbMaxProjectionAttempts = std::max(stats.nbMaxProjectionAttempts, nbProjectionAttempts);
 
+        if (success) {
+            ++stats.nbProjections;
+        }
+        else if (projectionFail_ != ProjectionFail::missingValue) {
+            stats.failures.push_back(ip);
+        }
+    };
 
-    {
-        trace::ProgressTimer progress("Projecting", nbOutputPoints, {"point"});
+    stats = {};
+    WeightMatrixBuilder builder(W.rows(), W.cols());  // structure to fill-in sparse matrix
 
-        // iterate over output points
-        for (const std::unique_ptr<repres::Iterator> it(out.iterator()); it->next(); ++progress) {
-            if (inDomain.contains(it->pointRotated())) {
-                size_t nbProjectionAttempts = 0;
+    if (const auto threads = util::parallel_num_threads(parametrisation_); threads > 1) {
 
+        // output points to project (in iteration order)
+        std::vector<std::pair<size_t, Point3>> points;
+        points.reserve(nbOutputPoints);
+
+        for (const std::unique_ptr<repres::Iterator> it(out.iterator()); it->next();) {
+            if (inDomain.contains(it->pointRotated())) {
                 auto ip = it->index();
                 ASSERT(ip < nbOutputPoints);
+                points.emplace_back(ip, point3(*(*it)));
+            }
+        }
 
-                // 3D projection, trying elements closest to p
-                const auto p = point3(*(*it));
-                auto closest = eTree->findInSphere(p, R);
-
-                atlas::interpolation::method::Ray ray(p.data());
-
-                // epsilon used to scale edge tolerance when projecting ray to intersect elements
-                // (if it fails consider increasing eps, or use ProjectionFail::increaseEpsilon)
-                double eps = 1e-15;
-
-                bool success = false;
-                for (size_t a = 0;
-                     a == 0 || (!success && a < nbMaxFailures && projectionFail_ == ProjectionFail::increaseEpsilon);
-                     eps *= 2., ++a) {
-                    for (const auto& close : closest) {
-                        ++nbProjectionAttempts;
-
-                        /*
-                         * Assumes:
-                         * - nb_cols == 3 implies triangle
-                         * - nb_cols == 4 implies quadrilateral
-                         * - no other element is supported at the time
-                         */
-                        const auto e = static_cast<atlas::idx_t>(close.value().payload());
-                        ASSERT(e < connectivity.rows());
-
-                        auto idx = [e, nbInputPoints, &connectivity](atlas::idx_t j) {
-                            auto x = static_cast<size_t>(connectivity(e, j));
-                            ASSERT(x < nbInputPoints);
-                            return x;
-                        };
-
-                        const auto nb_cols = connectivity.cols(e);
-
-                        std::unique_ptr<element_t> elem(
-                            nb_cols == 3   ? static_cast<element_t*>(new triag_t(inCoords, idx(0), idx(1), idx(2)))
-                            : nb_cols == 4 ? new quad_t(inCoords, idx(0), idx(1), idx(2), idx(3))
-                                           : NOTIMP);
-
-                        if (elem->intersects(ray, eps)) {
-                            elem->append_triplets(ip, nbRealPts, weights_triplets);
-                            success = true;
-                            break;
-                        }
-                    }
-                }
+        // project contiguous blocks of points, with per-thread builders and statistics
+        trace::Timer timer("Projecting " + std::to_string(points.size()) + " points, " + std::to_string(threads) +
+                           " threads");
 
-                nbMaxElementsSearched   = std::max(nbMaxElementsSearched, closest.size());
-                nbMinElementsSearched   = std::min(nbMinElementsSearched, closest.size());
-                nbMaxProjectionAttempts = std::max(nbMaxProjectionAttempts, nbProjectionAttempts);
+        std::vector<WeightMatrixBuilder> block_builders;
+        block_builders.reserve(threads);
+        for (size_t b = 0; b < threads; ++b) {
+            block_builders.emplace_back(W.rows(), W.cols());
+        }
 
-                if (success) {
-                    ++nbProjections;
-                }
-                else if (projectionFail_ != ProjectionFail::missingValue) {
-                    failures.emplace_front(ip, it->pointUnrotated());
-                    ++nbFailures;
-                }
+        std::vector<ProjectionStatistics> block_stats(threads);
+
+        auto blocks = util::parallel_for_blocks(points.size(), threads, [&](size_t b, size_t begin, size_t end) {
+            auto& block = block_builders[b];
+            block.reserve((end - begin) * 4);  // preallocate space as if all elements where quads
+
+            for (auto i = begin; i < end; ++i) {
+                project(points[i].first, points[i].second, block, block_stats[b]);
             }
+        });
+
+        // merge in block order (same as serial)
+        for (size_t b = 0; b < blocks; ++b) {
+            builder.append(std::move(block_builders[b]));
+            stats += block_stats[b];
         }
     }
+    else {
+        builder.reserve(nbOutputPoints * 4);  // preallocate space as if all elements where quads
 
-    log << "Projected " << Log::Pretty(nbProjections) << " of " << Log::Pretty(nbOutputPoints, {"point"}) << "\n"
-        << "k-d tree: searched between " << Log::Pretty(nbMinElementsSearched) << " and "
-        << Log::Pretty(nbMaxElementsSearched, {"element"}) << ", with up to "
-        << Log::Pretty(nbMaxProjectionAttempts, {"projection attempt"}) << " (per point)" << std::endl;
+        trace::ProgressTimer progress("Projecting", nbOutputPoints, {"point"});
 
-    if (nbFailures > 0) {
-        std::ostringstream msg;
-        msg << "Failed to project " << Log::Pretty(nbFailures, {"point"});
-        log << msg.str() << ":";
-        size_t count = 0;
-        for (const auto& f : failures) {
-            log << "\n\tpoint " << f.first << " " << f.second;
-            if (++count > nbMaxFailures) {
-                log << "\n\t...";
-                break;
+        // iterate over output points
+        for (const std::unique_ptr<repres::Iterator> it(out.iterator()); it->next(); ++progress) {
+            if (inDomain.contains(it->pointRotated())) {
+                auto ip = it->index();
+                ASSERT(ip < nbOutputPoints);
+
+                project(ip, point3(*(*it)), builder, stats);
             }
         }
-        log << std::endl;
-        throw exception::SeriousBug(msg.str());
     }
 
+    log << "Projected " << Log::Pretty(stats.nbProjections) << " of " << Log::Pretty(nbOutputPoints, {"point"})
+        << "\n"
+        << "k-d tree: searched between " << Log::Pretty(stats.nbMinElementsSearched) << " and "
+        << Log::Pretty(stats.nbMaxElementsSearched, {"element"}) << ", with up to "
+        << Log::Pretty(stats.nbMaxProjectionAttempts, {"projection attempt"}) << " (per point)" << std::endl;
 
     // fill sparse matrix
-    ASSERT_NONEMPTY_INTERPOLATION("FiniteElement", !weights_triplets.empty());
-    W.setFromTriplets(weights_triplets);
+    ASSERT_NONEMPTY_INTERPOLATION("FiniteElement", !builder.empty());
+    builder.build(W);
 }
 
 
@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <limits>
+#include <vector>
+
 #include "mir/method/MethodWeighted.h"
 #include "mir/util/MeshGeneratorParameters.h"
 #include "mir/util/Types.h"
@@ -34,6 +37,17 @@ public:
         };
     };
 
+    /// Projection statistics, combined (in order) over blocks of output points
+    struct ProjectionStatistics {
+        size_t nbMaxElementsSearched   = 0;
+        size_t nbMinElementsSearched   = std::numeric_limits<size_t>::max();
+        size_t nbMaxProjectionAttempts = 0;
+        size_t nbProjections           = 0;
+        std::vector<size_t> failures;  // output points failing projection (unless projecting to missing values)
+
+        ProjectionStatistics& operator+=(const ProjectionStatistics&);
+    };
+
     // -- Exceptions
     // None
 
@@ -74,6 +88,10 @@ protected:
 
     atlas::Mesh atlasMesh(util::MIRStatistics&, const repres::Representation&) const;
 
+    /// Assemble matrix, without reporting projection failures (so they can be checked by the caller)
+    void assemble(util::MIRStatistics&, WeightMatrix&, const repres::Representation& in,
+                  const repres::Representation& out, ProjectionStatistics&) const;
+
     // -- Overridden methods
     // None
 
@@ -14,12 +14,13 @@
 
 #include <algorithm>
 #include <forward_list>
-#include <iterator>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 #include "eckit/types/FloatCompare.h"
 
+#include "mir/method/WeightMatrixBuilder.h"
 #include "mir/param/MIRParametrisation.h"
 #include "mir/repres/Iterator.h"
 #include "mir/repres/Representation.h"
@@ -65,10 +66,8 @@ void GridBoxAverage::assemble(util::MIRStatistics& /*unused*/, WeightMatrix& W,
 
 
     // init structure used to fill in sparse matrix
-    // TODO: triplets, really? why not writing to the matrix directly?
-    std::vector<WeightMatrix::Triplet> weights_triplets;
+    WeightMatrixBuilder builder(W.rows(), W.cols());
     std::vector<WeightMatrix::Triplet> triplets;
-    std::vector<search::PointSearch::PointValueType> closest;
 
 
     // set input and output grid boxes
@@ -107,58 +106,86 @@ void GridBoxAverage::assemble(util::MIRStatistics& /*unused*/, WeightMatrix& W,
     {
         trace::ProgressTimer progress("Intersecting", outBoxes.size(), gridBoxes);
 
-        for (const std::unique_ptr<repres::Iterator> it(out.iterator()); it->next();) {
-            if (++progress) {
-                log << *tree << std::endl;
-            }
+        // output points, looked up in batches
+        const auto batch = search::PointSearch::batchSize();
 
+        std::vector<size_t> indices;
+        std::vector<Point3> points;
+        std::vector<PointLatLon> pointsUnrotated;
+        std::vector<size_t> offsets;
+        std::vector<search::PointSearch::ValueType> closest;
+        std::vector<double> distances;
 
+        auto intersect = [&]() {
             // lookup
-            tree->closestWithinRadius(point3(*(*it)), R, closest);
-            ASSERT(!closest.empty());
+            tree->closestWithinRadius(points.data(), points.size(), R, offsets, closest, distances);
+
+            for (size_t k = 0; k < points.size(); ++k) {
+                if (++progress) {
+                    log << *tree << std::endl;
+                }
 
+                ASSERT(offsets[k] < offsets[k + 1]);
 
-            // calculate grid box intersections
-            triplets.clear();
-            triplets.reserve(closest.size());
 
-            auto i          = it->index();
-            const auto& box = outBoxes.at(i);
-            double area     = box.area();
-            ASSERT(area > 0.);
+                // calculate grid box intersections
+                triplets.clear();
+                triplets.reserve(offsets[k + 1] - offsets[k]);
 
-            double sumSmallAreas = 0.;
-            bool areaMatch       = false;
-            for (auto& c : closest) {
-                auto j        = c.payload();
-                auto smallBox = inBoxes.at(j);
+                auto i          = indices[k];
+                const auto& box = outBoxes.at(i);
+                double area     = box.area();
+                ASSERT(area > 0.);
 
-                if (box.intersects(smallBox)) {
-                    double smallArea = smallBox.area();
-                    ASSERT(smallArea > 0.);
+                double sumSmallAreas = 0.;
+                bool areaMatch       = false;
+                for (auto c = offsets[k]; c < offsets[k + 1]; ++c) {
+                    auto j        = closest[c];
+                    auto smallBox = inBoxes.at(j);
 
-                    // weight clipped as numerical conditioning for intersection
-                    triplets.emplace_back(i, j, std::min(1., smallArea / area));
-                    sumSmallAreas += smallArea;
+                    if (box.intersects(smallBox)) {
+                        double smallArea = smallBox.area();
+                        ASSERT(smallArea > 0.);
 
-                    if ((areaMatch = eckit::types::is_approximately_equal(area, sumSmallAreas, 1. /*m^2*/))) {
-                        break;
+                        // weight clipped as numerical conditioning for intersection
+                        triplets.emplace_back(i, j, std::min(1., smallArea / area));
+                        sumSmallAreas += smallArea;
+
+                        if ((areaMatch = eckit::types::is_approximately_equal(area, sumSmallAreas, 1. /*m^2*/))) {
+                            break;
+                        }
                     }
                 }
-            }
 
 
-            // insert the interpolant weights into the global (sparse) interpolant matrix
-            if (areaMatch) {
-                std::copy(triplets.begin(), triplets.end(), std::back_inserter(weights_triplets));
+                // insert the interpolant weights into the global (sparse) interpolant matrix
+                if (areaMatch) {
+                    builder.add(triplets);
+                }
+                else {
+                    ++nbFailures;
+                    failures.emplace_front(i, pointsUnrotated[k]);
+                }
             }
-            else {
-                ++nbFailures;
-                failures.emplace_front(i, it->pointUnrotated());
+
+            indices.clear();
+            points.clear();
+            pointsUnrotated.clear();
+        };
+
+        for (const std::unique_ptr<repres::Iterator> it(out.iterator()); it->next();) {
+            indices.push_back(it->index());
+            points.emplace_back(point3(*(*it)));
+            pointsUnrotated.emplace_back(it->pointUnrotated());
+
+            if (points.size() == batch) {
+                intersect();
             }
         }
+
+        intersect();
     }
-    log << "Intersected " << Log::Pretty(weights_triplets.size(), gridBoxes) << std::endl;
+    log << "Intersected " << Log::Pretty(builder.nonZeros(), gridBoxes) << std::endl;
 
     if (nbFailures > 0) {
         auto& warning = Log::warning();
@@ -176,8 +203,8 @@ void GridBoxAverage::assemble(util::MIRStatistics& /*unused*/, WeightMatrix& W,
 
 
     // fill sparse matrix
-    ASSERT_NONEMPTY_INTERPOLATION("GridBoxMethod", !weights_triplets.empty());
-    W.setFromTriplets(weights_triplets);
+    ASSERT_NONEMPTY_INTERPOLATION("GridBoxMethod", !builder.empty());
+    builder.build(W);
 }
 
 
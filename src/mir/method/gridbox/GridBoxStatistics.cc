@@ -17,9 +17,11 @@
 #include <ostream>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 #include "eckit/log/JSON.h"
 
+#include "mir/method/WeightMatrixBuilder.h"
 #include "mir/method/gridbox/GridBoxMethod.h"
 #include "mir/method/solver/Statistics.h"
 #include "mir/param/MIRParametrisation.h"
@@ -68,8 +70,7 @@ void GridBoxStatistics::assemble(util::MIRStatistics& /*unused*/, WeightMatrix&
 
 
     // init structure used to fill in sparse matrix
-    // TODO: triplets, really? why not writing to the matrix directly?
-    std::vector<WeightMatrix::Triplet> weights_triplets;
+    WeightMatrixBuilder builder(W.rows(), W.cols());
     std::vector<search::PointSearch::PointValueType> closest;
 
 
@@ -117,42 +118,59 @@ void GridBoxStatistics::assemble(util::MIRStatistics& /*unused*/, WeightMatrix&
             return {pll[1], pll[0]};
         };
 
-        for (size_t i = 0; i < outBoxes.size(); ++i) {
-            if (++progress) {
-                log << *tree << std::endl;
-            }
+        // grid box centres, looked up in batches
+        const auto batch = search::PointSearch::batchSize();
 
+        std::vector<Point3> centres;
+        std::vector<size_t> offsets;
 
-            // lookup
-            const auto& box = outBoxes[i];
-            tree->closestWithinRadius(point3(box.centre()), R, closest);
-            if (closest.empty()) {
-                continue;
+        for (size_t first = 0; first < outBoxes.size(); first += batch) {
+            const auto count = std::min(batch, outBoxes.size() - first);
+
+            centres.clear();
+            for (size_t i = first; i < first + count; ++i) {
+                centres.emplace_back(point3(outBoxes[i].centre()));
             }
 
+            // lookup
+            tree->closestWithinRadius(centres.data(), count, R, offsets, closest);
 
-            // calculate grid box contains
-            std::vector<size_t> js;
-            for (auto& c : closest) {
-                if (box.contains(point_2D(c.point()))) {
-                    js.emplace_back(c.payload());
+            for (size_t k = 0; k < count; ++k) {
+                if (++progress) {
+                    log << *tree << std::endl;
+                }
+
+                if (offsets[k] == offsets[k + 1]) {
+                    continue;
                 }
-            }
 
 
-            // insert the interpolant weights into the global (sparse) interpolant matrix
-            if (!js.empty()) {
-                std::sort(js.begin(), js.end());
-                const auto weight = 1. / static_cast<double>(js.size());
-                for (auto j : js) {
-                    weights_triplets.emplace_back(i, j, weight);
+                // calculate grid box contains
+                const auto i    = first + k;
+                const auto& box = outBoxes[i];
+
+                std::vector<size_t> js;
+                for (auto c = offsets[k]; c < offsets[k + 1]; ++c) {
+                    if (box.contains(point_2D(closest[c].point()))) {
+                        js.emplace_back(closest[c].payload());
+                    }
+                }
+
+
+                // insert the interpolant weights into the global (sparse) interpolant matrix
+                if (!js.empty()) {
+                    std::sort(js.begin(), js.end());
+                    const auto weight = 1. / static_cast<double>(js.size());
+                    for (auto j : js) {
+                        builder.add(i, j, weight);
+                    }
+                }
+                else {
+                    ++nbFailures;
                 }
-            }
-            else {
-                ++nbFailures;
             }
         }
-        log << "Contained " << Log::Pretty(weights_triplets.size(), points) << " in "
+        log << "Contained " << Log::Pretty(builder.nonZeros(), points) << " in "
             << Log::Pretty(outBoxes.size(), boxes) << std::endl;
     }
 
@@ -172,8 +190,8 @@ void GridBoxStatistics::assemble(util::MIRStatistics& /*unused*/, WeightMatrix&
 
 
     // fill sparse matrix
-    ASSERT_NONEMPTY_INTERPOLATION("GridBoxStatistics", !weights_triplets.empty());
-    W.setFromTriplets(weights_triplets);
+    ASSERT_NONEMPTY_INTERPOLATION("GridBoxStatistics", !builder.empty());
+    builder.build(W);
 }
 
 
@@ -14,10 +14,14 @@
 
 #include <algorithm>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "eckit/log/JSON.h"
 #include "eckit/utils/MD5.h"
 
+#include "mir/method/WeightMatrixBuilder.h"
 #include "mir/method/knn/distance/DistanceWeighting.h"
 #include "mir/method/knn/pick/Pick.h"
 #include "mir/param/MIRParametrisation.h"
@@ -26,6 +30,7 @@
 #include "mir/util/Domain.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
+#include "mir/util/Parallel.h"
 #include "mir/util/Point2ToPoint3.h"
 #include "mir/util/Trace.h"
 #include "mir/util/Types.h"
@@ -77,72 +82,78 @@ void KNearestNeighbours::assemble(util::MIRStatistics& /*unused*/, WeightMatrix&
     util::Point2ToPoint3 point3(in, poleDisplacement());
 
     // init structure used to fill in sparse matrix
-    std::vector<WeightMatrix::Triplet> weights_triplets;
-    weights_triplets.reserve(nbOutputPoints * pick.n());
-
-    std::vector<search::PointSearch::PointValueType> closest;
-    std::vector<WeightMatrix::Triplet> triplets;
-
-    {
-        trace::ProgressTimer progress("Locating", nbOutputPoints, {"point"});
-        double search = 0;
-        double insert = 0;
-
-        for (const std::unique_ptr<repres::Iterator> it(out.iterator()); it->next();) {
-            if (++progress) {
-                log << "KNearestNeighbours: k-d tree"
-                       "\n"
-                       "search: "
-                    << search
-                    << "s"
-                       "\n"
-                       "insert: "
-                    << insert
-                    << "s"
-                       "\n"
-                    << sptree << std::endl;
-                search = insert = 0;
-            }
+    WeightMatrixBuilder builder(W.rows(), W.cols());
+
+    // output points to locate (in iteration order)
+    std::vector<size_t> indices;
+    std::vector<Point3> points;
+    indices.reserve(nbOutputPoints);
+    points.reserve(nbOutputPoints);
+
+    for (const std::unique_ptr<repres::Iterator> it(out.iterator()); it->next();) {
+        if (inDomain.contains(it->pointRotated())) {
+            auto ip = it->index();
+            ASSERT(ip < nbOutputPoints);
+            indices.push_back(ip);
+            points.emplace_back(point3(*(*it)));
+        }
+    }
 
-            if (inDomain.contains(it->pointRotated())) {
+    // locate and weight contiguous blocks of points, with per-block builders (a single block if not parallel);
+    // each block is searched in batches, bounding the memory for the neighbours
+    const auto threads = pick.parallel() ? util::parallel_num_threads(parametrisation_) : 1;
+    const auto batch   = search::PointSearch::batchSize();
 
-                // 3D point to lookup
-                const auto p = point3(*(*it));
+    trace::Timer locating("Locating " + std::to_string(points.size()) + " points, " + std::to_string(threads) +
+                          " threads");
 
-                // search
-                {
-                    double t = timer.elapsed();
-                    pick.pick(sptree, p, closest);
-                    search += timer.elapsed(t);
-                    if (closest.empty()) {
-                        continue;
-                    }
-                }
+    std::vector<WeightMatrixBuilder> block_builders;
+    block_builders.reserve(threads);
+    for (size_t b = 0; b < threads; ++b) {
+        block_builders.emplace_back(W.rows(), W.cols());
+    }
 
-                // calculate weights
-                auto ip = it->index();
-                ASSERT(ip < nbOutputPoints);
+    auto blocks = util::parallel_for_blocks(points.size(), threads, [&](size_t b, size_t begin, size_t end) {
+        std::vector<size_t> offsets;
+        pick::Pick::neighbours_t found;
+        pick::Pick::neighbours_t closest;
+        std::vector<WeightMatrix::Triplet> triplets;
 
-                distanceWeighting(ip, p, closest, triplets);
-                ASSERT(!triplets.empty());
+        auto& block = block_builders[b];
+        block.reserve((end - begin) * pick.n());
 
-                // insert weights into the global (sparse) interpolant matrix
-                {
-                    double t = timer.elapsed();
-                    std::copy(triplets.begin(), triplets.end(), std::back_inserter(weights_triplets));
-                    insert += timer.elapsed(t);
+        for (auto first = begin; first < end; first += batch) {
+            const auto count = std::min(batch, end - first);
+            pick.pick(sptree, points.data() + first, count, offsets, found);
+
+            for (size_t i = 0; i < count; ++i) {
+                if (offsets[i] == offsets[i + 1]) {
+                    continue;
                 }
+
+                closest.assign(found.begin() + long(offsets[i]), found.begin() + long(offsets[i + 1]));
+                distanceWeighting(indices[first + i], points[first + i], closest, triplets);
+                ASSERT(!triplets.empty());
+
+                block.add(triplets);
             }
         }
+    });
+
+    // merge in block order (rows in iteration order, independent of the number of threads)
+    for (size_t b = 0; b < blocks; ++b) {
+        builder.append(std::move(block_builders[b]));
     }
 
-    if (weights_triplets.empty()) {
+    log << "KNearestNeighbours: k-d tree\n" << sptree << std::endl;
+
+    if (builder.empty()) {
         throw exception::SeriousBug("KNearestNeighbours: failed to interpolate");
     }
 
     // fill-in sparse matrix
-    ASSERT_NONEMPTY_INTERPOLATION("KNearestNeighbours", !weights_triplets.empty());
-    W.setFromTriplets(weights_triplets);
+    ASSERT_NONEMPTY_INTERPOLATION("KNearestNeighbours", !builder.empty());
+    builder.build(W);
 }
 
 
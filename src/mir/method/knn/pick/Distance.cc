@@ -35,6 +35,12 @@ void Distance::pick(const search::PointSearch& tree, const Point3& p, Pick::neig
 }
 
 
+void Distance::pick(const search::PointSearch& tree, const Point3* points, size_t count, std::vector<size_t>& offsets,
+                    Pick::neighbours_t& closest) const {
+    tree.closestWithinRadius(points, count, distance_, offsets, closest);
+}
+
+
 size_t Distance::n() const {
     // NOTE: cannot be estimated
     return 4;
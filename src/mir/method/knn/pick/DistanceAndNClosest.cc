@@ -39,6 +39,13 @@ void DistanceAndNClosest::pick(const search::PointSearch& tree, const Point3& p,
 }
 
 
+void DistanceAndNClosest::pick(const search::PointSearch& tree, const Point3* points, size_t count,
+                               std::vector<size_t>& offsets, Pick::neighbours_t& closest) const {
+    withinRadiusOrPick(tree, points, count, distance_, nClosest_, [this](size_t n) { return n > nClosest_.n(); },
+                       offsets, closest);
+}
+
+
 size_t DistanceAndNClosest::n() const {
     return nClosest_.n();
 }
@@ -12,6 +12,8 @@
 
 #include "mir/method/knn/pick/LongestElementDiagonalAndNClosest.h"
 
+#include <algorithm>
+
 #include "eckit/log/JSON.h"
 #include "eckit/types/FloatCompare.h"
 #include "eckit/utils/MD5.h"
@@ -36,10 +38,11 @@ LongestElementDiagonalAndNClosest::LongestElementDiagonalAndNClosest(const param
 
 void LongestElementDiagonalAndNClosest::pick(const search::PointSearch& tree, const Point3& p,
                                              Pick::neighbours_t& closest) const {
-    // This method switches between k- and distance-based searches for performance
+    // This method switches between k- and distance-based searches for performance; the switch is only a hint, so it
+    // does not need ordering with respect to other memory operations
     ASSERT(0. < distance_);
 
-    if (nClosestFirst_) {
+    if (nClosestFirst_.load(std::memory_order_relaxed)) {
         tree.closestNPoints(p, nClosest_, closest);
 
         auto r2 = Point3::distance2(p, closest.back().point());
@@ -47,7 +50,7 @@ void LongestElementDiagonalAndNClosest::pick(const search::PointSearch& tree, co
             tree.closestWithinRadius(p, distance_, closest);
             ASSERT(closest.size() <= nClosest_);
 
-            nClosestFirst_ = false;
+            nClosestFirst_.store(false, std::memory_order_relaxed);
         }
     }
     else {
@@ -56,12 +59,33 @@ void LongestElementDiagonalAndNClosest::pick(const search::PointSearch& tree, co
         if (closest.size() > nClosest_) {
             closest.erase(closest.begin() + long(nClosest_), closest.end());
 
-            nClosestFirst_ = true;
+            nClosestFirst_.store(true, std::memory_order_relaxed);
         }
     }
 }
 
 
+void LongestElementDiagonalAndNClosest::pick(const search::PointSearch& tree, const Point3* points, size_t count,
+                                             std::vector<size_t>& offsets, Pick::neighbours_t& closest) const {
+    // A batch is searched by distance (limited to the N closest), independently of the search order hint
+    ASSERT(0. < distance_);
+
+    std::vector<size_t> withinOffsets;
+    neighbours_t within;
+    tree.closestWithinRadius(points, count, distance_, withinOffsets, within);
+
+    offsets.assign(1, 0);
+    closest.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const auto first = within.begin() + long(withinOffsets[i]);
+        const auto size  = std::min(withinOffsets[i + 1] - withinOffsets[i], nClosest_);
+
+        closest.insert(closest.end(), first, first + long(size));
+        offsets.push_back(closest.size());
+    }
+}
+
+
 size_t LongestElementDiagonalAndNClosest::n() const {
     return nClosest_;
 }
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "mir/method/knn/pick/Pick.h"
 
 
@@ -22,6 +24,8 @@ struct LongestElementDiagonalAndNClosest : Pick {
     explicit LongestElementDiagonalAndNClosest(const param::MIRParametrisation&);
 
     void pick(const search::PointSearch&, const Point3&, neighbours_t&) const override;
+    void pick(const search::PointSearch&, const Point3* points, size_t count, std::vector<size_t>& offsets,
+              neighbours_t&) const override;
     size_t n() const override;
     bool sameAs(const Pick&) const override;
 
@@ -34,7 +38,7 @@ private:
     const size_t nClosest_;
     mutable double distance_;
     mutable double distance2_;
-    mutable bool nClosestFirst_;
+    mutable std::atomic<bool> nClosestFirst_;  // search order hint, shared by threads (see parallel())
 };
 
 
@@ -35,6 +35,17 @@ void NClosest::pick(const search::PointSearch& tree, const Point3& p, Pick::neig
 }
 
 
+void NClosest::pick(const search::PointSearch& tree, const Point3* points, size_t count, std::vector<size_t>& offsets,
+                    Pick::neighbours_t& closest) const {
+    tree.closestNPoints(points, count, nClosest_, closest);
+
+    offsets.resize(count + 1);
+    for (size_t i = 0; i <= count; ++i) {
+        offsets[i] = i * nClosest_;
+    }
+}
+
+
 size_t NClosest::n() const {
     return nClosest_;
 }
@@ -22,6 +22,8 @@ struct NClosest : Pick {
     explicit NClosest(const param::MIRParametrisation&);
 
     void pick(const search::PointSearch&, const Point3&, neighbours_t&) const override;
+    void pick(const search::PointSearch&, const Point3* points, size_t count, std::vector<size_t>& offsets,
+              neighbours_t&) const override;
     size_t n() const override;
     bool sameAs(const Pick&) const override;
 
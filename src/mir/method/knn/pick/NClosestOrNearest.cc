@@ -62,6 +62,39 @@ void NClosestOrNearest::pick(const search::PointSearch& tree, const Point3& p, P
 }
 
 
+void NClosestOrNearest::pick(const search::PointSearch& tree, const Point3* points, size_t count,
+                             std::vector<size_t>& offsets, Pick::neighbours_t& closest) const {
+    auto n = nClosest_ == 1 ? 2 : nClosest_;
+
+    neighbours_t nearest;
+    tree.closestNPoints(points, count, n, nearest);
+    ASSERT(nearest.size() == count * n);
+
+    neighbours_t within;
+
+    offsets.assign(1, 0);
+    closest.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const auto& p    = points[i];
+        const auto first = nearest.begin() + long(i * n);
+
+        // as above, all points inside radius if closest and farthest nb. are at the same distance
+        auto nearest2  = Point3::distance2(p, first->point());
+        auto farthest2 = Point3::distance2(p, (first + long(n - 1))->point());
+        if (eckit::types::is_approximately_equal(nearest2, farthest2, distanceTolerance2_)) {
+            auto radius = std::sqrt(farthest2) + distanceTolerance_;
+            tree.closestWithinRadius(p, radius, within);
+            closest.insert(closest.end(), within.begin(), within.end());
+        }
+        else {
+            closest.insert(closest.end(), first, first + long(nClosest_));
+        }
+
+        offsets.push_back(closest.size());
+    }
+}
+
+
 size_t NClosestOrNearest::n() const {
     return nClosest_;
 }
@@ -23,6 +23,8 @@ struct NClosestOrNearest : Pick {
     explicit NClosestOrNearest(const param::MIRParametrisation&);
 
     void pick(const search::PointSearch&, const Point3&, neighbours_t&) const override;
+    void pick(const search::PointSearch&, const Point3* points, size_t count, std::vector<size_t>& offsets,
+              neighbours_t&) const override;
     size_t n() const override;
     bool sameAs(const Pick&) const override;
     void hash(eckit::MD5&) const override;
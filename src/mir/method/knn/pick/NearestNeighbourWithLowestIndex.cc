@@ -64,6 +64,48 @@ void NearestNeighbourWithLowestIndex::pick(const search::PointSearch& tree, cons
 }
 
 
+void NearestNeighbourWithLowestIndex::pick(const search::PointSearch& tree, const Point3* points, size_t count,
+                                           std::vector<size_t>& offsets, neighbours_t& closest) const {
+    offsets.resize(count + 1);
+    for (size_t i = 0; i <= count; ++i) {
+        offsets[i] = i;
+    }
+
+    if (nClosest_ == 1) {
+        tree.closestNPoints(points, count, 1, closest);
+        return;
+    }
+
+
+    // search for neighbour points
+    neighbours_t neighbours;
+    tree.closestNPoints(points, count, nClosest_, neighbours);
+    ASSERT(neighbours.size() == count * nClosest_);
+
+
+    // choose closest neighbour point with the lowest index (payload), as above
+    closest.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const auto& point = points[i];
+        const auto* first = neighbours.data() + i * nClosest_;
+
+        size_t c        = 0;
+        const double d2 = Point3::distance2(point, first[0].point());
+
+        for (size_t j = 1; j < nClosest_; ++j) {
+            if (eckit::types::is_strictly_greater(Point3::distance2(point, first[j].point()), d2)) {
+                break;
+            }
+            if (first[c].payload() > first[j].payload()) {
+                c = j;
+            }
+        }
+
+        closest.push_back(first[c]);
+    }
+}
+
+
 size_t NearestNeighbourWithLowestIndex::n() const {
     return 1;
 }
@@ -42,6 +42,59 @@ void Pick::distance(const repres::Representation& /*unused*/) const {
 }
 
 
+void Pick::pick(const search::PointSearch& tree, const Point3* points, size_t count, std::vector<size_t>& offsets,
+                neighbours_t& closest) const {
+    // by default, pick point by point
+    neighbours_t neighbours;
+
+    offsets.assign(1, 0);
+    closest.clear();
+    for (size_t i = 0; i < count; ++i) {
+        pick(tree, points[i], neighbours);
+        closest.insert(closest.end(), neighbours.begin(), neighbours.end());
+        offsets.push_back(closest.size());
+    }
+}
+
+
+void Pick::withinRadiusOrPick(const search::PointSearch& tree, const Point3* points, size_t count, double radius,
+                              const Pick& other, const std::function<bool(size_t)>& replace,
+                              std::vector<size_t>& offsets, neighbours_t& closest) {
+    std::vector<size_t> withinOffsets;
+    neighbours_t within;
+    tree.closestWithinRadius(points, count, radius, withinOffsets, within);
+
+    // points to pick again, as a batch
+    std::vector<size_t> which;
+    std::vector<Point3> again;
+    for (size_t i = 0; i < count; ++i) {
+        if (replace(withinOffsets[i + 1] - withinOffsets[i])) {
+            which.push_back(i);
+            again.push_back(points[i]);
+        }
+    }
+
+    std::vector<size_t> otherOffsets;
+    neighbours_t others;
+    other.pick(tree, again.data(), again.size(), otherOffsets, others);
+
+    offsets.assign(1, 0);
+    closest.clear();
+    for (size_t i = 0, k = 0; i < count; ++i) {
+        if (k < which.size() && which[k] == i) {
+            closest.insert(closest.end(), others.begin() + long(otherOffsets[k]),
+                           others.begin() + long(otherOffsets[k + 1]));
+            ++k;
+        }
+        else {
+            closest.insert(closest.end(), within.begin() + long(withinOffsets[i]),
+                           within.begin() + long(withinOffsets[i + 1]));
+        }
+        offsets.push_back(closest.size());
+    }
+}
+
+
 const std::string& Pick::type() const {
     static const std::string TYPE{"nearest-method"};
     return TYPE;
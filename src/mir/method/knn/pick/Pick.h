@@ -12,7 +12,9 @@
 
 #pragma once
 
+#include <functional>
 #include <iosfwd>
+#include <vector>
 
 #include "mir/search/PointSearch.h"
 
@@ -44,17 +46,31 @@ public:
     Pick& operator=(Pick&&)      = delete;
 
     virtual void pick(const search::PointSearch&, const Point3&, neighbours_t&) const = 0;
+
+    /// Picks neighbours of a batch of points, point i neighbours are at [offsets[i], offsets[i + 1]) of closest
+    virtual void pick(const search::PointSearch&, const Point3* points, size_t count, std::vector<size_t>& offsets,
+                      neighbours_t& closest) const;
+
     virtual size_t n() const                                                          = 0;
     virtual bool sameAs(const Pick&) const                                            = 0;
     virtual void hash(eckit::MD5&) const                                              = 0;
 
     virtual void distance(const repres::Representation&) const;
 
+    /// If pick() can be called concurrently, with reproducible results
+    virtual bool parallel() const { return true; }
+
     virtual void json(eckit::JSON&) const = 0;
 
 protected:
     const std::string& type() const;
 
+    /// Batch of neighbours within a radius, replaced for the points where replace(number of neighbours) is true by
+    /// the neighbours picked by another method
+    static void withinRadiusOrPick(const search::PointSearch&, const Point3* points, size_t count, double radius,
+                                   const Pick& other, const std::function<bool(size_t)>& replace,
+                                   std::vector<size_t>& offsets, neighbours_t& closest);
+
 private:
     virtual void print(std::ostream&) const = 0;
 
@@ -12,6 +12,7 @@
 
 #include "mir/method/knn/pick/Sample.h"
 
+#include <algorithm>
 #include <cstdlib>
 
 #include "eckit/log/JSON.h"
@@ -53,6 +54,32 @@ void Sample::pick(const search::PointSearch& tree, const Point3& p, Pick::neighb
 }
 
 
+void Sample::pick(const search::PointSearch& tree, const Point3* points, size_t count, std::vector<size_t>& offsets,
+                  Pick::neighbours_t& closest) const {
+    std::vector<size_t> withinOffsets;
+    neighbours_t within;
+    tree.closestWithinRadius(points, count, distance_, withinOffsets, within);
+
+    // reservoir sampling in-place, point by point (as above)
+    offsets.assign(1, 0);
+    closest.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const auto first = within.begin() + long(withinOffsets[i]);
+        const auto size  = withinOffsets[i + 1] - withinOffsets[i];
+
+        for (size_t n = nClosest_; n < size; ++n) {
+            auto r = static_cast<size_t>(std::rand()) % n;
+            if (r < nClosest_) {
+                first[long(r)] = first[long(n)];
+            }
+        }
+
+        closest.insert(closest.end(), first, first + long(std::min(size, nClosest_)));
+        offsets.push_back(closest.size());
+    }
+}
+
+
 size_t Sample::n() const {
     return nClosest_;
 }
@@ -34,6 +34,20 @@ void SortedSample::pick(const search::PointSearch& tree, const Point3& p, Pick::
               });
 }
 
+
+void SortedSample::pick(const search::PointSearch& tree, const Point3* points, size_t count,
+                        std::vector<size_t>& offsets, Pick::neighbours_t& closest) const {
+    sample_.pick(tree, points, count, offsets, closest);
+
+    for (size_t i = 0; i < count; ++i) {
+        const auto& p = points[i];
+        std::sort(closest.begin() + long(offsets[i]), closest.begin() + long(offsets[i + 1]),
+                  [&p](const Pick::neighbours_t::value_type& a, const Pick::neighbours_t::value_type& b) {
+                      return Point3::distance2(a.point(), p) < Point3::distance2(b.point(), p);
+                  });
+    }
+}
+
 size_t SortedSample::n() const {
     return sample_.n();
 }
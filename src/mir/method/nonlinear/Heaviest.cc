@@ -25,34 +25,25 @@ namespace mir::method::nonlinear {
 Heaviest::Heaviest(const param::MIRParametrisation& param) : NonLinear(param) {}
 
 
-bool Heaviest::treatment(DenseMatrix& /*A*/, WeightMatrix& W, DenseMatrix& /*B*/, const MIRValuesVector& /*unused*/,
-                         const double& /*missingValue*/) const {
-
-    auto* data = const_cast<WeightMatrix::Scalar*>(W.data());
-
-    WeightMatrix::iterator it(W);
-    for (WeightMatrix::Size r = 0, i = 0; r < W.rows(); ++r) {
-
-        // find heaviest-weighted column in row
-        auto k                 = i;
-        auto heaviest_index    = i;
-        double heaviest_weight = -1.;
-        size_t N_entries       = 0;
-
-        const WeightMatrix::iterator end = W.end(r);
-        for (; it != end; ++it, ++i, ++N_entries) {
-            if (heaviest_weight < data[i]) {
-                heaviest_weight = data[i];
-                heaviest_index  = i;
-            }
-        }
+bool Heaviest::treatmentRow(WeightMatrix::Scalar* weights, const WeightMatrix::Index* /*cols*/, size_t N,
+                            const MIRValuesVector& /*unused*/, const double& /*missingValue*/) const {
+
+    // find heaviest-weighted column in row
+    size_t heaviest_index  = 0;
+    double heaviest_weight = -1.;
 
-        // set the heaviest-weighted column in row to 1, other entries to 0
-        for (auto j = k; j < k + N_entries; ++j) {
-            data[j] = j == heaviest_index ? 1. : 0.;
+    for (size_t j = 0; j < N; ++j) {
+        if (heaviest_weight < weights[j]) {
+            heaviest_weight = weights[j];
+            heaviest_index  = j;
         }
     }
 
+    // set the heaviest-weighted column in row to 1, other entries to 0
+    for (size_t j = 0; j < N; ++j) {
+        weights[j] = j == heaviest_index ? 1. : 0.;
+    }
+
     return true;
 }
 
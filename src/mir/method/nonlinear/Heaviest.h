@@ -22,8 +22,8 @@ struct Heaviest : NonLinear {
     explicit Heaviest(const param::MIRParametrisation&);
 
 private:
-    bool treatment(DenseMatrix& A, WeightMatrix& W, DenseMatrix& B, const MIRValuesVector&,
-                   const double& missingValue) const override;
+    bool treatmentRow(WeightMatrix::Scalar* weights, const WeightMatrix::Index* cols, size_t N,
+                      const MIRValuesVector&, const double& missingValue) const override;
     bool sameAs(const NonLinear&) const override;
     void print(std::ostream&) const override;
     void hash(eckit::MD5&) const override;
@@ -19,7 +19,6 @@
 #include "eckit/types/FloatCompare.h"
 #include "eckit/utils/MD5.h"
 
-#include "mir/util/Exceptions.h"
 #include "mir/util/Types.h"
 
 
@@ -29,64 +28,44 @@ namespace mir::method::nonlinear {
 MissingIfAllMissing::MissingIfAllMissing(const param::MIRParametrisation& param) : NonLinear(param) {}
 
 
-bool MissingIfAllMissing::treatment(DenseMatrix& /*A*/, WeightMatrix& W, DenseMatrix& /*B*/,
-                                    const MIRValuesVector& values, const double& missingValue) const {
+bool MissingIfAllMissing::treatmentRow(WeightMatrix::Scalar* weights, const WeightMatrix::Index* cols, size_t N,
+                                       const MIRValuesVector& values, const double& missingValue) const {
 
-    // correct matrix weigths for the missing values
-    // (force a missing value only if all row values are missing)
-    ASSERT(W.cols() == values.size());
+    // count missing values, accumulate weights (disregarding missing values)
+    size_t i_missing = 0;
+    size_t N_missing = 0;
+    double sum       = 0.;
 
-    auto* data = const_cast<WeightMatrix::Scalar*>(W.data());
-    bool modif = false;
-
-    WeightMatrix::Size i = 0;
-    WeightMatrix::iterator it(W);
-    for (WeightMatrix::Size r = 0; r < W.rows(); ++r) {
-        const WeightMatrix::iterator end = W.end(r);
-
-        // count missing values, accumulate weights (disregarding missing values)
-        size_t i_missing = i;
-        size_t N_missing = 0;
-        size_t N_entries = 0;
-        double sum       = 0.;
-
-        WeightMatrix::iterator kt(it);
-        WeightMatrix::Size k = i;
-        for (; it != end; ++it, ++i, ++N_entries) {
+    for (size_t j = 0; j < N; ++j) {
+        if (values[size_t(cols[j])] == missingValue) {
+            ++N_missing;
+            i_missing = j;
+        }
+        else {
+            sum += weights[j];
+        }
+    }
 
-            const bool miss = values[it.col()] == missingValue;
+    if (N_missing == 0) {
+        return false;
+    }
 
-            if (miss) {
-                ++N_missing;
-                i_missing = i;
-            }
-            else {
-                sum += *it;
-            }
+    // weights redistribution: zero-weight all missing values, linear re-weighting for the others;
+    // the result is missing value if all values in row are missing
+    if (N_missing == N || eckit::types::is_approximately_equal(sum, 0.)) {
+        for (size_t j = 0; j < N; ++j) {
+            weights[j] = j == i_missing ? 1. : 0.;
         }
-
-        // weights redistribution: zero-weight all missing values, linear re-weighting for the others;
-        // the result is missing value if all values in row are missing
-        if (N_missing > 0) {
-            if (N_missing == N_entries || eckit::types::is_approximately_equal(sum, 0.)) {
-
-                for (WeightMatrix::Size j = k; j < k + N_entries; ++j) {
-                    data[j] = j == i_missing ? 1. : 0.;
-                }
-            }
-            else {
-
-                const double factor = 1. / sum;
-                for (WeightMatrix::Size j = k; j < k + N_entries; ++j, ++kt) {
-                    const bool miss = values[kt.col()] == missingValue;
-                    data[j]         = miss ? 0. : (factor * data[j]);
-                }
-            }
-            modif = true;
+    }
+    else {
+        const double factor = 1. / sum;
+        for (size_t j = 0; j < N; ++j) {
+            const bool miss = values[size_t(cols[j])] == missingValue;
+            weights[j]      = miss ? 0. : (factor * weights[j]);
         }
     }
 
-    return modif;
+    return true;
 }
 
 
@@ -18,8 +18,6 @@
 #include "eckit/log/JSON.h"
 #include "eckit/utils/MD5.h"
 
-#include "mir/util/Exceptions.h"
-
 
 namespace mir::method::nonlinear {
 
@@ -27,48 +25,27 @@ namespace mir::method::nonlinear {
 MissingIfAnyMissing::MissingIfAnyMissing(const param::MIRParametrisation& param) : NonLinear(param) {}
 
 
-bool MissingIfAnyMissing::treatment(DenseMatrix& /*A*/, WeightMatrix& W, DenseMatrix& /*B*/,
-                                    const MIRValuesVector& values, const double& missingValue) const {
-
-    // correct matrix weigths for the missing values
-    // (force a missing value only if any row values is missing)
-    ASSERT(W.cols() == values.size());
-
-    auto* data = const_cast<WeightMatrix::Scalar*>(W.data());
-    bool modif = false;
-
-    WeightMatrix::Size i = 0;
-    WeightMatrix::iterator it(W);
-    for (WeightMatrix::Size r = 0; r < W.rows(); ++r) {
-        const WeightMatrix::iterator end = W.end(r);
-
-        // count missing values, accumulate weights (disregarding missing values)
-        size_t i_missing = i;
-        size_t N_missing = 0;
-        size_t N_entries = 0;
-
-        WeightMatrix::iterator kt(it);
-        WeightMatrix::Size k = i;
-        for (; it != end; ++it, ++i, ++N_entries) {
+bool MissingIfAnyMissing::treatmentRow(WeightMatrix::Scalar* weights, const WeightMatrix::Index* cols, size_t N,
+                                       const MIRValuesVector& values, const double& missingValue) const {
 
-            const bool miss = values[it.col()] == missingValue;
-
-            if (miss) {
-                ++N_missing;
-                i_missing = i;
-            }
+    // find a missing value
+    size_t i_missing = 0;
+    for (; i_missing < N; ++i_missing) {
+        if (values[size_t(cols[i_missing])] == missingValue) {
+            break;
         }
+    }
 
-        // if any values in row are missing, force missing value
-        if (N_missing > 0) {
-            for (WeightMatrix::Size j = k; j < k + N_entries; ++j) {
-                data[j] = j == i_missing ? 1. : 0.;
-            }
-            modif = true;
-        }
+    if (i_missing == N) {
+        return false;
+    }
+
+    // if any values in row are missing, force missing value
+    for (size_t j = 0; j < N; ++j) {
+        weights[j] = j == i_missing ? 1. : 0.;
     }
 
-    return modif;
+    return true;
 }
 
 
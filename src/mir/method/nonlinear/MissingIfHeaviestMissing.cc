@@ -19,8 +19,6 @@
 #include "eckit/types/FloatCompare.h"
 #include "eckit/utils/MD5.h"
 
-#include "mir/util/Exceptions.h"
-
 
 namespace mir::method::nonlinear {
 
@@ -28,70 +26,54 @@ namespace mir::method::nonlinear {
 MissingIfHeaviestMissing::MissingIfHeaviestMissing(const param::MIRParametrisation& param) : NonLinear(param) {}
 
 
-bool MissingIfHeaviestMissing::treatment(DenseMatrix& /*A*/, WeightMatrix& W, DenseMatrix& /*B*/,
-                                         const MIRValuesVector& values, const double& missingValue) const {
-
-    // correct matrix weigths for the missing values
-    ASSERT(W.cols() == values.size());
-
-    auto* data = const_cast<WeightMatrix::Scalar*>(W.data());
-    bool modif = false;
+bool MissingIfHeaviestMissing::treatmentRow(WeightMatrix::Scalar* weights, const WeightMatrix::Index* cols,
+                                            size_t N, const MIRValuesVector& values,
+                                            const double& missingValue) const {
 
-    WeightMatrix::Size i = 0;
-    WeightMatrix::iterator it(W);
-    for (WeightMatrix::Size r = 0; r < W.rows(); ++r) {
-        const WeightMatrix::iterator end = W.end(r);
+    // count missing values, accumulate weights (disregarding missing values) and find maximum weight in row
+    size_t i_missing         = 0;
+    size_t N_missing         = 0;
+    double sum               = 0.;
+    double heaviest          = -1.;
+    bool heaviest_is_missing = false;
 
-        // count missing values, accumulate weights (disregarding missing values) and find maximum weight in row
-        size_t i_missing         = i;
-        size_t N_missing         = 0;
-        size_t N_entries         = 0;
-        double sum               = 0.;
-        double heaviest          = -1.;
-        bool heaviest_is_missing = false;
+    for (size_t j = 0; j < N; ++j) {
+        const bool miss = values[size_t(cols[j])] == missingValue;
 
-        WeightMatrix::iterator kt(it);
-        WeightMatrix::Size k = i;
-        for (; it != end; ++it, ++i, ++N_entries) {
+        if (miss) {
+            ++N_missing;
+            i_missing = j;
+        }
+        else {
+            sum += weights[j];
+        }
 
-            const bool miss = values[it.col()] == missingValue;
+        if (heaviest < weights[j]) {
+            heaviest            = weights[j];
+            heaviest_is_missing = miss;
+        }
+    }
 
-            if (miss) {
-                ++N_missing;
-                i_missing = i;
-            }
-            else {
-                sum += *it;
-            }
+    if (N_missing == 0) {
+        return false;
+    }
 
-            if (heaviest < data[i]) {
-                heaviest            = data[i];
-                heaviest_is_missing = miss;
-            }
+    // weights redistribution: zero-weight all missing values, linear re-weighting for the others;
+    // if all values are missing, or the closest value is missing, force missing value
+    if (N_missing == N || heaviest_is_missing || eckit::types::is_approximately_equal(sum, 0.)) {
+        for (size_t j = 0; j < N; ++j) {
+            weights[j] = j == i_missing ? 1. : 0.;
         }
-
-        // weights redistribution: zero-weight all missing values, linear re-weighting for the others;
-        // if all values are missing, or the closest value is missing, force missing value
-        if (N_missing > 0) {
-            if (N_missing == N_entries || heaviest_is_missing || eckit::types::is_approximately_equal(sum, 0.)) {
-
-                for (WeightMatrix::Size j = k; j < k + N_entries; ++j) {
-                    data[j] = j == i_missing ? 1. : 0.;
-                }
-            }
-            else {
-
-                const double factor = 1. / sum;
-                for (WeightMatrix::Size j = k; j < k + N_entries; ++j, ++kt) {
-                    const bool miss = values[kt.col()] == missingValue;
-                    data[j]         = miss ? 0. : (factor * data[j]);
-                }
-            }
-            modif = true;
+    }
+    else {
+        const double factor = 1. / sum;
+        for (size_t j = 0; j < N; ++j) {
+            const bool miss = values[size_t(cols[j])] == missingValue;
+            weights[j]      = miss ? 0. : (factor * weights[j]);
         }
     }
 
-    return modif;
+    return true;
 }
 
 
@@ -25,8 +25,8 @@ namespace mir::method::nonlinear {
 NoNonLinear::NoNonLinear(const param::MIRParametrisation& param) : NonLinear(param) {}
 
 
-bool NoNonLinear::treatment(DenseMatrix& /*A*/, WeightMatrix& /*W*/, DenseMatrix& /*B*/,
-                            const MIRValuesVector& /*unused*/, const double& /*missingValue*/) const {
+bool NoNonLinear::treatmentRow(WeightMatrix::Scalar* /*weights*/, const WeightMatrix::Index* /*cols*/,
+                               size_t /*N*/, const MIRValuesVector& /*unused*/, const double& /*missingValue*/) const {
     // no non-linear treatment
     return false;
 }
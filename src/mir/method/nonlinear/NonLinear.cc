@@ -17,6 +17,7 @@
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
 #include "mir/util/Mutex.h"
+#include "mir/util/Parallel.h"
 
 
 namespace mir::method::nonlinear {
@@ -37,6 +38,94 @@ NonLinear::NonLinear(const param::MIRParametrisation& /*unused*/) {}
 NonLinear::~NonLinear() = default;
 
 
+bool NonLinear::treatment(DenseMatrix& /*A*/, WeightMatrix& W, DenseMatrix& /*B*/, const MIRValuesVector& values,
+                          const double& missingValue) const {
+    ASSERT(W.cols() == values.size());
+
+    auto* data        = const_cast<WeightMatrix::Scalar*>(W.data());
+    const auto* outer = W.outer();
+    const auto* inner = W.inner();
+
+    bool modif = false;
+    for (WeightMatrix::Size r = 0; r < W.rows(); ++r) {
+        const auto k = size_t(outer[r]);
+        const auto N = size_t(outer[r + 1]) - k;
+
+        if (N > 0 && treatmentRow(data + k, inner + k, N, values, missingValue)) {
+            modif = true;
+        }
+    }
+
+    return modif;
+}
+
+
+// row products, for rows of FIXED entries each (row offsets are not read, loops over entries have a constant
+// trip count) or of variable entries (FIXED = 0)
+template <size_t FIXED>
+static void multiply_rows(const std::vector<std::unique_ptr<const NonLinear>>& nonLinear, const WeightMatrix& W,
+                          const DenseMatrix& A, DenseMatrix& B, const MIRValuesVector& values,
+                          const double& missingValue, size_t threads) {
+    const auto* data  = W.data();
+    const auto* outer = W.outer();
+    const auto* inner = W.inner();
+    const auto Nc     = A.cols();
+
+    util::parallel_for_blocks(W.rows(), threads, [&](size_t /*block*/, size_t begin, size_t end) {
+        std::vector<WeightMatrix::Scalar> weights(FIXED);  // row weights copy, reused
+
+        for (auto r = begin; r < end; ++r) {
+            const auto k = FIXED > 0 ? r * FIXED : size_t(outer[r]);
+            const auto N = FIXED > 0 ? FIXED : size_t(outer[r + 1]) - k;
+
+            weights.assign(data + k, data + k + N);
+            if (N > 0) {
+                for (const auto& n : nonLinear) {
+                    n->treatmentRow(weights.data(), inner + k, N, values, missingValue);
+                }
+            }
+
+            for (WeightMatrix::Size c = 0; c < Nc; ++c) {
+                double sum = 0.;
+                for (size_t j = 0; j < N; ++j) {
+                    if (weights[j] != 0.) {
+                        sum += weights[j] * A(WeightMatrix::Size(inner[k + j]), c);
+                    }
+                }
+                B(r, c) = sum;
+            }
+        }
+    });
+}
+
+
+void multiply(const std::vector<std::unique_ptr<const NonLinear>>& nonLinear, const WeightMatrix& W,
+              const DenseMatrix& A, DenseMatrix& B, const MIRValuesVector& values, const double& missingValue,
+              size_t threads, size_t rowNonZeros) {
+    ASSERT(A.rows() == W.cols());
+    ASSERT(B.rows() == W.rows());
+    ASSERT(A.cols() == B.cols());
+    ASSERT(values.size() == W.cols());
+    ASSERT(rowNonZeros == 0 || W.nonZeros() == W.rows() * rowNonZeros);
+
+    // common row widths: nearest neighbour(s), linear/bilinear elements, k-nearest neighbours
+    switch (rowNonZeros) {
+        case 1:
+            multiply_rows<1>(nonLinear, W, A, B, values, missingValue, threads);
+            return;
+        case 3:
+            multiply_rows<3>(nonLinear, W, A, B, values, missingValue, threads);
+            return;
+        case 4:
+            multiply_rows<4>(nonLinear, W, A, B, values, missingValue, threads);
+            return;
+        default:
+            multiply_rows<0>(nonLinear, W, A, B, values, missingValue, threads);
+            return;
+    }
+}
+
+
 NonLinearFactory::NonLinearFactory(const std::string& name) : name_(name) {
     util::call_once(once, init);
     util::lock_guard<util::recursive_mutex> lock(*local_mutex);
@@ -13,7 +13,9 @@
 #pragma once
 
 #include <iosfwd>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "mir/method/MethodWeighted.h"
 
@@ -32,9 +34,17 @@ public:
 
     virtual ~NonLinear();
 
-    /// Update interpolation linear system to account for non-linearities
-    virtual bool treatment(DenseMatrix& A, WeightMatrix& W, DenseMatrix& B, const MIRValuesVector&,
-                           const double& missingValue) const = 0;
+    /// Update interpolation linear system to account for non-linearities (row by row, modifying the matrix)
+    bool treatment(DenseMatrix& A, WeightMatrix& W, DenseMatrix& B, const MIRValuesVector&,
+                   const double& missingValue) const;
+
+    /// Update a matrix row weights to account for non-linearities, in place (weights can be a copy of the matrix row,
+    /// with cols the respective input columns)
+    virtual bool treatmentRow(WeightMatrix::Scalar* weights, const WeightMatrix::Index* cols, size_t N,
+                              const MIRValuesVector&, const double& missingValue) const = 0;
+
+    /// Input value is considered missing (treatments depend on input values only through this test)
+    virtual bool isMissing(const double& value, const double& missingValue) const { return value == missingValue; }
 
     virtual bool sameAs(const NonLinear&) const                   = 0;
     virtual void hash(eckit::MD5&) const                          = 0;
@@ -58,6 +68,17 @@ private:
 };
 
 
+/**
+ * Matrix multiplication B = W A, applying the non-linear treatments (in order) to a copy of each matrix row weights
+ * before the row product, so the (possibly cached) matrix is not modified; entries of zero weight are skipped
+ * @param threads maximum number of threads, over contiguous blocks of rows
+ * @param rowNonZeros number of entries of every row, if the same (see WeightMatrixStructure), otherwise 0
+ */
+void multiply(const std::vector<std::unique_ptr<const NonLinear>>&, const WeightMatrix& W, const DenseMatrix& A,
+              DenseMatrix& B, const MIRValuesVector&, const double& missingValue, size_t threads = 1,
+              size_t rowNonZeros = 0);
+
+
 class NonLinearFactory {
 private:
     std::string name_;
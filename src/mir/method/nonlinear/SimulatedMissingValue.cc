@@ -20,7 +20,6 @@
 #include "eckit/utils/MD5.h"
 
 #include "mir/param/MIRParametrisation.h"
-#include "mir/util/Exceptions.h"
 
 
 namespace mir::method::nonlinear {
@@ -32,75 +31,62 @@ SimulatedMissingValue::SimulatedMissingValue(const param::MIRParametrisation& pa
 }
 
 
-bool SimulatedMissingValue::treatment(DenseMatrix& /*A*/, WeightMatrix& W, DenseMatrix& /*B*/,
-                                      const MIRValuesVector& values, const double& /*ignored*/) const {
+bool SimulatedMissingValue::treatmentRow(WeightMatrix::Scalar* weights, const WeightMatrix::Index* cols, size_t N,
+                                         const MIRValuesVector& values, const double& /*ignored*/) const {
     using eckit::types::is_approximately_equal;
 
     auto missingValue = [this](double value) { return is_approximately_equal(value, missingValue_, epsilon_); };
 
-    // correct matrix weigths for the missing values
-    // (force a missing value only if any row values is missing)
-    ASSERT(W.cols() == values.size());
-
-    auto* data = const_cast<WeightMatrix::Scalar*>(W.data());
-    bool modif = false;
-
-    WeightMatrix::Size i = 0;
-    WeightMatrix::iterator it(W);
-    for (WeightMatrix::Size r = 0; r < W.rows(); ++r) {
-        const WeightMatrix::iterator end = W.end(r);
-
-        // count missing values, accumulate weights (disregarding missing values) and find maximum weight in row
-        size_t i_missing = i;
-        size_t N_missing = 0;
-        size_t N_entries = 0;
-        double sum       = 0.;
-
-        double heaviest          = -1.;
-        bool heaviest_is_missing = false;
-
-        WeightMatrix::iterator kt(it);
-        auto k = i;
-        for (; it != end; ++it, ++i, ++N_entries) {
-
-            const bool miss = missingValue(values[it.col()]);
-
-            if (miss) {
-                ++N_missing;
-                i_missing = i;
-            }
-            else {
-                sum += *it;
-            }
-
-            if (heaviest < data[i]) {
-                heaviest            = data[i];
-                heaviest_is_missing = miss;
-            }
+    // count missing values, accumulate weights (disregarding missing values) and find maximum weight in row
+    size_t i_missing = 0;
+    size_t N_missing = 0;
+    double sum       = 0.;
+
+    double heaviest          = -1.;
+    bool heaviest_is_missing = false;
+
+    for (size_t j = 0; j < N; ++j) {
+        const bool miss = missingValue(values[size_t(cols[j])]);
+
+        if (miss) {
+            ++N_missing;
+            i_missing = j;
+        }
+        else {
+            sum += weights[j];
         }
 
-        // weights redistribution: zero-weight all (simulated) missing values, linear re-weighting for the others;
-        // if all values are missing, or the closest value is missing, force missing value
-        if (N_missing > 0) {
-            if (N_missing == N_entries || heaviest_is_missing || is_approximately_equal(sum, 0.)) {
-
-                for (auto j = k; j < k + N_entries; ++j) {
-                    data[j] = j == i_missing ? 1. : 0.;
-                }
-            }
-            else {
-
-                const double factor = 1. / sum;
-                for (auto j = k; j < k + N_entries; ++j, ++kt) {
-                    const bool miss = missingValue(values[kt.col()]);
-                    data[j]         = miss ? 0. : (factor * data[j]);
-                }
-            }
-            modif = true;
+        if (heaviest < weights[j]) {
+            heaviest            = weights[j];
+            heaviest_is_missing = miss;
+        }
+    }
+
+    if (N_missing == 0) {
+        return false;
+    }
+
+    // weights redistribution: zero-weight all (simulated) missing values, linear re-weighting for the others;
+    // if all values are missing, or the closest value is missing, force missing value
+    if (N_missing == N || heaviest_is_missing || is_approximately_equal(sum, 0.)) {
+        for (size_t j = 0; j < N; ++j) {
+            weights[j] = j == i_missing ? 1. : 0.;
+        }
+    }
+    else {
+        const double factor = 1. / sum;
+        for (size_t j = 0; j < N; ++j) {
+            const bool miss = missingValue(values[size_t(cols[j])]);
+            weights[j]      = miss ? 0. : (factor * weights[j]);
         }
     }
 
-    return modif;
+    return true;
+}
+
+
+bool SimulatedMissingValue::isMissing(const double& value, const double& /*ignored*/) const {
+    return eckit::types::is_approximately_equal(value, missingValue_, epsilon_);
 }
 
 
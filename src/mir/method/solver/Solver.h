@@ -47,6 +47,9 @@ public:
     virtual void solve(const DenseMatrix& A, const WeightMatrix& W, DenseMatrix& B,
                        const double& missingValue) const = 0;
 
+    /// If solve() supports multi-column operands (one or more column blocks per field)
+    virtual bool multipleColumns() const { return false; }
+
     virtual bool sameAs(const Solver&) const = 0;
     virtual void hash(eckit::MD5&) const     = 0;
     virtual void json(eckit::JSON&) const    = 0;
@@ -13,14 +13,17 @@
 #include "mir/method/voronoi/VoronoiMethod.h"
 
 #include <algorithm>
+#include <functional>
 #include <ostream>
 #include <set>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 #include "eckit/log/JSON.h"
 #include "eckit/utils/MD5.h"
 
+#include "mir/method/WeightMatrixBuilder.h"
 #include "mir/repres/Iterator.h"
 #include "mir/repres/Representation.h"
 #include "mir/search/PointSearch.h"
@@ -38,7 +41,6 @@ namespace {
 
 struct Biplet : std::pair<size_t, size_t> {
     using pair::pair;
-    operator WeightMatrix::Triplet() const { return {first, second, 1. /*non-zero*/}; }
     bool operator<(const Biplet& other) const {
         return first < other.first || (first == other.first && second < other.second);
     }
@@ -81,23 +83,46 @@ void VoronoiMethod::assemble(util::MIRStatistics& /*unused*/, WeightMatrix& W, c
     std::set<Biplet> biplets;
 
 
-    {
-        trace::ProgressTimer progress("assemble: input-based assign", Nin, {"point"});
+    // lookup points in batches, assigning each point (by position) its neighbours
+    using assign_t = std::function<void(size_t, const search::PointSearch::PointValueType&)>;
+    auto lookup    = [this, &tree, &log](const std::vector<Point3>& points, trace::ProgressTimer& progress,
+                                      const assign_t& assign) {
+        const auto batch = search::PointSearch::batchSize();
 
+        std::vector<size_t> offsets;
         std::vector<search::PointSearch::PointValueType> closest;
-        for (const std::unique_ptr<repres::Iterator> it(in.iterator()); it->next();) {
-            if (++progress) {
-                log << *tree << std::endl;
-            }
+        for (size_t first = 0; first < points.size(); first += batch) {
+            const auto count = std::min(batch, points.size() - first);
+            pick_.pick(*tree, points.data() + first, count, offsets, closest);
+
+            for (size_t i = 0; i < count; ++i) {
+                if (++progress) {
+                    log << *tree << std::endl;
+                }
 
-            // lookup
-            pick_.pick(*tree, point3(*(*it)), closest);
-            for (auto& c : closest) {
-                auto i = c.payload();
-                biplets.emplace(i, it->index());
-                assigned[i] = true;
+                for (auto c = offsets[i]; c < offsets[i + 1]; ++c) {
+                    assign(first + i, closest[c]);
+                }
             }
         }
+    };
+
+
+    {
+        trace::ProgressTimer progress("assemble: input-based assign", Nin, {"point"});
+
+        std::vector<size_t> indices;
+        std::vector<Point3> points;
+        for (const std::unique_ptr<repres::Iterator> it(in.iterator()); it->next();) {
+            indices.push_back(it->index());
+            points.emplace_back(point3(*(*it)));
+        }
+
+        lookup(points, progress, [&](size_t k, const search::PointSearch::PointValueType& c) {
+            auto i = c.payload();
+            biplets.emplace(i, indices[k]);
+            assigned[i] = true;
+        });
     }
 
 
@@ -115,33 +140,36 @@ void VoronoiMethod::assemble(util::MIRStatistics& /*unused*/, WeightMatrix& W, c
         {
             trace::ProgressTimer progress("assemble: output-based assign", Nout - Nassigned, {"point"});
 
-            std::vector<search::PointSearch::PointValueType> closest;
+            std::vector<size_t> indices;
+            std::vector<Point3> points;
             for (const std::unique_ptr<repres::Iterator> it(out.iterator()); it->next();) {
-                auto i = it->index();
-                if (assigned[i]) {
-                    continue;
-                }
-
-                if (++progress) {
-                    log << *tree << std::endl;
-                }
-
-                // lookup
-                pick_.pick(*tree, point3(*(*it)), closest);
-                for (auto& c : closest) {
-                    auto j = c.payload();
-                    biplets.emplace(i, j);  // won't insert biplet if existing
+                if (auto i = it->index(); !assigned[i]) {
+                    indices.push_back(i);
+                    points.emplace_back(point3(*(*it)));
                 }
             }
+
+            lookup(points, progress, [&](size_t k, const search::PointSearch::PointValueType& c) {
+                auto j = c.payload();
+                biplets.emplace(indices[k], j);  // won't insert biplet if existing
+            });
         }
     }
 
     {
         trace::Timer time("assemble: fill sparse matrix");
 
-        // TODO: triplets, really? why not writing to the matrix directly?
         ASSERT_NONEMPTY_INTERPOLATION("VoronoiMethod", !biplets.empty());
-        W.setFromTriplets({biplets.begin(), biplets.end()});
+
+        // biplets are ordered by row then column
+        WeightMatrixBuilder builder(W.rows(), W.cols());
+        builder.reserve(biplets.size());
+        for (const auto& b : biplets) {
+            builder.add(b.first, b.second, 1. /*non-zero*/);
+        }
+
+        std::set<Biplet>().swap(biplets);
+        builder.build(W);
     }
 }
 
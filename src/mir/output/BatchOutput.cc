@@ -0,0 +1,132 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/output/BatchOutput.h"
+
+#include <ostream>
+#include <sstream>
+
+#include "mir/action/context/Context.h"
+#include "mir/data/MIRField.h"
+#include "mir/input/MultiDimensionalInput.h"
+#include "mir/util/Exceptions.h"
+
+
+namespace mir::output {
+
+
+static input::MultiDimensionalInput& batch(context::Context& ctx) {
+    auto* multi = dynamic_cast<input::MultiDimensionalInput*>(&ctx.input());
+    if (multi == nullptr) {
+        std::ostringstream os;
+        os << "BatchOutput: not implemented for input of type: " << ctx.input();
+        throw exception::SeriousBug(os.str());
+    }
+    return *multi;
+}
+
+
+BatchOutput::BatchOutput(MIROutput& output) : output_(output) {}
+
+
+BatchOutput::~BatchOutput() = default;
+
+
+size_t BatchOutput::copy(const param::MIRParametrisation& param, context::Context& ctx) {
+    auto& multi = batch(ctx);
+    size_t size = 0;
+
+    for (auto* d : multi.dimensions_) {
+        context::Context componentCtx(*d, ctx.statistics());
+        size += output_.copy(param, componentCtx);
+    }
+
+    return size;
+}
+
+
+size_t BatchOutput::save(const param::MIRParametrisation& param, context::Context& ctx) {
+    auto& field = ctx.field();
+    auto& multi = batch(ctx);
+    ASSERT(field.dimensions() == multi.dimensions());
+
+    size_t size = 0;
+    for (size_t which = 0; which < field.dimensions(); ++which) {
+        context::Context componentCtx(*(multi.dimensions_[which]), ctx.statistics());
+
+        data::MIRField u(field.representation(), field.hasMissing(), field.missingValue());
+        u.update(field.direct(which), 0);
+        u.metadata(0, field.metadata(which));
+        componentCtx.field(u);
+
+        size += output_.save(param, componentCtx);
+    }
+
+    return size;
+}
+
+
+size_t BatchOutput::set(const param::MIRParametrisation& param, context::Context& ctx) {
+    auto& field = ctx.field();
+    auto& multi = batch(ctx);
+    ASSERT(field.dimensions() == multi.dimensions());
+
+    size_t size = 0;
+    for (size_t which = 0; which < field.dimensions(); ++which) {
+        context::Context componentCtx(*(multi.dimensions_[which]), ctx.statistics());
+
+        data::MIRField u(field.representation(), field.hasMissing(), field.missingValue());
+        u.update(field.direct(which), 0);
+        u.metadata(0, field.metadata(which));
+        componentCtx.field(u);
+
+        size += output_.set(param, componentCtx);
+    }
+
+    return size;
+}
+
+
+bool BatchOutput::sameAs(const MIROutput& other) const {
+    const auto* o = dynamic_cast<const BatchOutput*>(&other);
+    return (o != nullptr) && output_.sameAs(o->output_);
+}
+
+
+bool BatchOutput::sameParametrisation(const param::MIRParametrisation& param1,
+                                      const param::MIRParametrisation& param2) const {
+    return output_.sameParametrisation(param1, param2);
+}
+
+
+bool BatchOutput::printParametrisation(std::ostream& out, const param::MIRParametrisation& param) const {
+    return output_.printParametrisation(out, param);
+}
+
+
+void BatchOutput::prepare(const param::MIRParametrisation& parametrisation, action::ActionPlan& plan,
+                          MIROutput& output) {
+    output_.prepare(parametrisation, plan, output);
+}
+
+
+void BatchOutput::flush() {
+    output_.flush();
+}
+
+
+void BatchOutput::print(std::ostream& out) const {
+    out << "BatchOutput[" << output_ << "]";
+}
+
+
+}  // namespace mir::output
@@ -0,0 +1,53 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include "mir/output/MIROutput.h"
+
+
+namespace mir::output {
+
+
+/// Writes fields batched as one multi-dimensional field (input::MultiDimensionalInput) to the same output, one field
+/// per dimension in batch order, each with its own input (GRIB) metadata
+class BatchOutput : public MIROutput {
+public:
+    // -- Constructors
+
+    explicit BatchOutput(MIROutput&);
+
+    // -- Destructor
+
+    ~BatchOutput() override;
+
+private:
+    // -- Members
+
+    MIROutput& output_;
+
+    // -- Overridden methods
+
+    // From MIROutput
+    size_t copy(const param::MIRParametrisation&, context::Context&) override;
+    size_t save(const param::MIRParametrisation&, context::Context&) override;
+    size_t set(const param::MIRParametrisation&, context::Context&) override;
+    bool sameAs(const MIROutput&) const override;
+    bool sameParametrisation(const param::MIRParametrisation&, const param::MIRParametrisation&) const override;
+    bool printParametrisation(std::ostream&, const param::MIRParametrisation&) const override;
+    void prepare(const param::MIRParametrisation&, action::ActionPlan&, MIROutput&) override;
+    void flush() override;
+    void print(std::ostream&) const override;
+};
+
+
+}  // namespace mir::output
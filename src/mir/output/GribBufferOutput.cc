@@ -0,0 +1,58 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/output/GribBufferOutput.h"
+
+#include <ostream>
+#include <utility>
+
+
+namespace mir::output {
+
+
+GribBufferOutput::GribBufferOutput() = default;
+
+
+GribBufferOutput::~GribBufferOutput() = default;
+
+
+GribBufferOutput::Messages GribBufferOutput::release() {
+    Messages messages;
+    messages.swap(messages_);
+    return messages;
+}
+
+
+void GribBufferOutput::write(const Messages& messages, GribOutput& output) {
+    for (const auto& message : messages) {
+        output.write(message.data.data(), message.data.size(), message.interpolated);
+    }
+}
+
+
+void GribBufferOutput::out(const void* message, size_t length, bool interpolated) {
+    const auto* data = static_cast<const char*>(message);
+    messages_.push_back({std::vector<char>(data, data + length), interpolated});
+}
+
+
+void GribBufferOutput::print(std::ostream& out) const {
+    out << "GribBufferOutput[messages=" << messages_.size() << "]";
+}
+
+
+bool GribBufferOutput::sameAs(const MIROutput& other) const {
+    return this == &other;
+}
+
+
+}  // namespace mir::output
@@ -0,0 +1,94 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mir/output/GribOutput.h"
+
+
+namespace mir::output {
+
+
+/// Keeps encoded messages in memory, in order, to be written later to another output (eg. in input order)
+class GribBufferOutput : public GribOutput {
+public:
+    // -- Types
+
+    struct Message {
+        std::vector<char> data;
+        bool interpolated;
+    };
+
+    using Messages = std::vector<Message>;
+
+    // -- Exceptions
+    // None
+
+    // -- Constructors
+
+    GribBufferOutput();
+
+    // -- Destructor
+
+    ~GribBufferOutput() override;
+
+    // -- Convertors
+    // None
+
+    // -- Operators
+    // None
+
+    // -- Methods
+
+    /// Encoded messages, in order (output is left empty)
+    Messages release();
+
+    /// Write messages to another output, in order
+    static void write(const Messages&, GribOutput&);
+
+    // -- Overridden methods
+    // None
+
+    // -- Class members
+    // None
+
+    // -- Class methods
+    // None
+
+private:
+    // -- Members
+
+    Messages messages_;
+
+    // -- Methods
+    // None
+
+    // -- Overridden methods
+
+    void out(const void* message, size_t length, bool interpolated) override;
+    void print(std::ostream&) const override;
+    bool sameAs(const MIROutput&) const override;
+
+    // -- Class members
+    // None
+
+    // -- Class methods
+    // None
+
+    // -- Friends
+    // None
+};
+
+
+}  // namespace mir::output
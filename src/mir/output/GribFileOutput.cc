@@ -22,6 +22,8 @@ GribFileOutput::GribFileOutput(const eckit::PathName& path, bool append) :
 
 
 GribFileOutput::~GribFileOutput() {
+    close();
+
     if (handle_ != nullptr) {
         handle_->close();
         delete handle_;
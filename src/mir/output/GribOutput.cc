@@ -57,7 +57,9 @@
 namespace mir::output {
 
 
+// Protect shared state only: input handles (when cloned before modifying) and output stream
 static util::recursive_mutex local_mutex;
+static util::once_flag once;
 
 
 #define X(a) Log::debug() << "  GRIB encoding: " << #a << " = " << (a) << std::endl
@@ -69,6 +71,22 @@ static util::recursive_mutex local_mutex;
 }
 
 
+static void init() {
+    // Set error callback handling (throws), process-wide
+    codes_set_codes_assertion_failed_proc(&eccodes_assertion);
+}
+
+
+static grib_handle* clone(grib_handle* h) {
+    // Encoding works on its own handle, so only cloning needs protecting
+    util::lock_guard<util::recursive_mutex> lock(local_mutex);
+
+    auto* c = codes_handle_clone(h);
+    ASSERT(c != nullptr);
+    return c;
+}
+
+
 GribOutput::GribOutput() : interpolated_(0), saved_(0) {}
 
 
@@ -85,6 +103,19 @@ size_t GribOutput::saved() const {
 }
 
 
+void GribOutput::write(const void* message, size_t length, bool interpolated) {
+    util::lock_guard<util::recursive_mutex> lock(local_mutex);
+
+    if (interpolated) {
+        interpolated_++;
+    }
+    else {
+        saved_++;
+    }
+    out(message, length, interpolated);
+}
+
+
 size_t GribOutput::copy(const param::MIRParametrisation& /*unused*/, context::Context& ctx) {
     saved_++;
 
@@ -109,7 +140,11 @@ size_t GribOutput::copy(const param::MIRParametrisation& /*unused*/, context::Co
 
         GRIB_CALL(codes_get_message(h, &message, &size));
 
-        out(message, size, false);
+        {
+            util::lock_guard<util::recursive_mutex> lock(local_mutex);
+            out(message, size, false);
+        }
+
         total += size;
     }
 
@@ -212,17 +247,15 @@ size_t GribOutput::save(const param::MIRParametrisation& param, context::Context
     std::unique_ptr<grib::Packing> pack(grib::Packing::build(param));
     ASSERT(pack);
 
-    for (size_t i = 0; i < field.dimensions(); i++) {
+    util::call_once(once, init);
 
-        // Protect ecCodes and set error callback handling (throws)
-        util::lock_guard<util::recursive_mutex> lock(local_mutex);
-        codes_set_codes_assertion_failed_proc(&eccodes_assertion);
+    for (size_t i = 0; i < field.dimensions(); i++) {
 
         // Special case where only values are changing; handle is cloned, and new values are set
         if (param.userParametrisation().has("filter")) {
 
             // Make sure handle deleted even in case of exception
-            auto* h = codes_handle_clone(input.gribHandle(i));
+            auto* h = clone(input.gribHandle(i));
             HandleDeleter hf(h);
 
             long n;
@@ -251,13 +284,18 @@ size_t GribOutput::save(const param::MIRParametrisation& param, context::Context
             GRIB_CALL(codes_check_message_header(message, size, PRODUCT_GRIB));
             GRIB_CALL(codes_check_message_footer(message, size, PRODUCT_GRIB));
 
-            out(message, size, true);
+            {
+                util::lock_guard<util::recursive_mutex> lock(local_mutex);
+                out(message, size, true);
+            }
+
             total += size;
 
             continue;
         }
 
-        auto* h = input.gribHandle(field.handle(i));  // Base class throws if input cannot provide handle
+        // Base class throws if input cannot provide handle (only read, codes_grib_util_set_spec creates a new handle)
+        auto* h = input.gribHandle(field.handle(i));
 
         grib_info info;
 
@@ -415,6 +453,7 @@ size_t GribOutput::save(const param::MIRParametrisation& param, context::Context
 
         {
             auto timing(ctx.statistics().saveTimer());
+            util::lock_guard<util::recursive_mutex> lock(local_mutex);
             out(message, size, true);
         }
 
@@ -479,14 +518,12 @@ size_t GribOutput::set(const param::MIRParametrisation& param, context::Context&
 
     ASSERT(field.dimensions() == 1);
 
-    for (size_t i = 0; i < field.dimensions(); i++) {
+    util::call_once(once, init);
 
-        // Protect ecCodes and set error callback handling (throws)
-        util::lock_guard<util::recursive_mutex> lock(local_mutex);
-        codes_set_codes_assertion_failed_proc(&eccodes_assertion);
+    for (size_t i = 0; i < field.dimensions(); i++) {
 
         // Make sure handle deleted even in case of exception
-        auto* h = codes_handle_clone(input.gribHandle(field.handle(i)));
+        auto* h = clone(input.gribHandle(field.handle(i)));
         HandleDeleter hf(h);
 
         repres::RepresentationHandle repres(field.representation());
@@ -509,6 +546,7 @@ size_t GribOutput::set(const param::MIRParametrisation& param, context::Context&
 
         {
             auto timing(ctx.statistics().saveTimer());
+            util::lock_guard<util::recursive_mutex> lock(local_mutex);
             out(message, size, true);
         }
 
@@ -598,6 +636,7 @@ size_t GribOutput::save_with_metkit(const param::MIRParametrisation& param, cont
 
         {
             auto timing(ctx.statistics().saveTimer());
+            util::lock_guard<util::recursive_mutex> lock(local_mutex);
             out(h->messageData().data(), h->messageSize(), true);
         }
 
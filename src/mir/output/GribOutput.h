@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "mir/output/MIROutput.h"
 
 
@@ -47,6 +49,9 @@ public:
 
     bool do_save_with_metkit(const param::MIRParametrisation&);
 
+    /// Write an encoded message (eg. encoded by another output)
+    void write(const void* message, size_t length, bool interpolated);
+
 protected:
     // -- Methods
 
@@ -55,8 +60,8 @@ protected:
 private:
     // -- Members
 
-    size_t interpolated_;
-    size_t saved_;
+    std::atomic<size_t> interpolated_;
+    std::atomic<size_t> saved_;
 
     // -- Methods
 
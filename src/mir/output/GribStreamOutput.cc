@@ -10,22 +10,209 @@
  */
 
 
+#include "mir/output/GribStreamOutput.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "eckit/config/Resource.h"
 #include "eckit/io/DataHandle.h"
 
-#include "mir/output/GribStreamOutput.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Log.h"
 
 
 namespace mir::output {
 
 
+static size_t block_size() {
+    // bytes per block written behind, 0 to write messages directly
+    static size_t size = eckit::Resource<size_t>("$MIR_GRIB_OUTPUT_BUFFER_SIZE", 0);
+    return size;
+}
+
+
+static size_t blocks() {
+    // blocks waiting to be written, at most
+    static size_t n = std::max<size_t>(1, eckit::Resource<size_t>("$MIR_GRIB_OUTPUT_BUFFERS", 4));
+    return n;
+}
+
+
+/// Coalesces messages into fixed-size blocks, written on a separate thread (bounded number of blocks in memory)
+class GribStreamOutput::WriteBehind {
+public:
+    WriteBehind(eckit::DataHandle& handle, size_t blockSize, size_t blocks) :
+        handle_(handle), blockSize_(blockSize), blocks_(blocks) {
+        ASSERT(blockSize_ > 0);
+        ASSERT(blocks_ > 0);
+
+        current_.reserve(blockSize_);
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    WriteBehind(const WriteBehind&) = delete;
+    WriteBehind(WriteBehind&&)      = delete;
+
+    ~WriteBehind() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!current_.empty() && !error_) {
+                queue_.emplace_back(std::move(current_));
+            }
+            stop_ = true;
+        }
+        cond_.notify_all();
+        thread_.join();
+    }
+
+    void operator=(const WriteBehind&) = delete;
+    void operator=(WriteBehind&&)      = delete;
+
+    void write(const void* message, size_t length) {
+        {
+            // report a writing error as soon as possible
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+        }
+
+        const auto* data = static_cast<const char*>(message);
+        while (length > 0) {
+            auto n = std::min(length, blockSize_ - current_.size());
+            current_.insert(current_.end(), data, data + n);
+            data += n;
+            length -= n;
+
+            if (current_.size() == blockSize_) {
+                submit();
+            }
+        }
+    }
+
+    void flush() {
+        if (!current_.empty()) {
+            submit();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this]() { return (queue_.empty() && !writing_) || error_; });
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    eckit::DataHandle& handle_;
+    const size_t blockSize_;
+    const size_t blocks_;
+
+    std::vector<char> current_;
+    std::deque<std::vector<char>> queue_;
+    bool writing_ = false;
+    bool stop_    = false;
+    std::exception_ptr error_;
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::thread thread_;
+
+    void submit() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this]() { return queue_.size() < blocks_ || error_; });
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+
+        queue_.emplace_back(std::move(current_));
+        cond_.notify_all();
+
+        current_ = std::vector<char>();
+        current_.reserve(blockSize_);
+    }
+
+    void run() {
+        for (;;) {
+            std::vector<char> block;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+
+                block = std::move(queue_.front());
+                queue_.pop_front();
+                writing_ = true;
+            }
+
+            try {
+                const auto len = long(block.size());
+                ASSERT(handle_.write(block.data(), len) == len);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                error_ = std::current_exception();
+                queue_.clear();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                writing_ = false;
+            }
+            cond_.notify_all();
+        }
+    }
+};
+
+
 GribStreamOutput::GribStreamOutput() = default;
 
 
-GribStreamOutput::~GribStreamOutput() = default;
+GribStreamOutput::~GribStreamOutput() {
+    close();
+}
+
+
+void GribStreamOutput::flush() {
+    if (writeBehind_) {
+        writeBehind_->flush();
+    }
+}
+
+
+void GribStreamOutput::close() {
+    if (writeBehind_) {
+        try {
+            writeBehind_->flush();
+        }
+        catch (std::exception& e) {
+            Log::error() << "GribStreamOutput: error writing buffered messages: " << e.what() << std::endl;
+        }
+        writeBehind_.reset();
+    }
+}
 
 
 void GribStreamOutput::out(const void* message, size_t length, bool /*interpolated*/) {
-    dataHandle().write(message, long(length));
+    if (block_size() > 0) {
+        if (!writeBehind_) {
+            Log::debug() << "GribStreamOutput: writing behind, in blocks of " << Log::Bytes(block_size()) << std::endl;
+            writeBehind_ = std::make_unique<WriteBehind>(dataHandle(), block_size(), blocks());
+        }
+
+        writeBehind_->write(message, length);
+        return;
+    }
+
+    ASSERT(dataHandle().write(message, long(length)) == long(length));
 }
 
 
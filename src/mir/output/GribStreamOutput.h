@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "mir/output/GribOutput.h"
 
 
@@ -46,7 +48,10 @@ public:
     // None
 
     // -- Overridden methods
-    // None
+    // From MIROutput
+
+    /// Write buffered messages, if writing behind (re-throws writing errors)
+    void flush() override;
 
     // -- Class members
     // None
@@ -60,6 +65,9 @@ protected:
 
     // -- Methods
 
+    /// Write buffered messages and stop writing behind, derived classes should call it before releasing their data
+    /// handle (does not throw, errors are only logged: call flush() to report them)
+    void close();
 
     // -- Overridden methods
     // None
@@ -71,8 +79,14 @@ protected:
     // None
 
 private:
+    // -- Types
+
+    class WriteBehind;
+
     // -- Members
 
+    std::unique_ptr<WriteBehind> writeBehind_;
+
     // -- Methods
 
     virtual eckit::DataHandle& dataHandle() = 0;
@@ -12,6 +12,7 @@
 
 #include "mir/output/MIROutput.h"
 
+#include <atomic>
 #include <sstream>
 
 #include "eckit/filesystem/PathName.h"
@@ -28,7 +29,10 @@
 namespace mir::output {
 
 
-MIROutput::MIROutput() = default;
+static std::atomic<size_t> next_id{0};
+
+
+MIROutput::MIROutput() : id_(next_id++) {}
 
 
 MIROutput::~MIROutput() = default;
@@ -174,4 +178,7 @@ void MIROutput::prepare(const param::MIRParametrisation& param, action::ActionPl
 }
 
 
+void MIROutput::flush() {}
+
+
 }  // namespace mir::output
@@ -65,6 +65,13 @@ public:
     virtual bool printParametrisation(std::ostream&, const param::MIRParametrisation&) const                   = 0;
     virtual void prepare(const param::MIRParametrisation&, action::ActionPlan&, MIROutput&);
 
+    /// Write buffered output, if any, re-throwing writing errors (call after the last field, errors are not reported
+    /// on destruction)
+    virtual void flush();
+
+    /// Unique (per process) identity, not reused (unlike an address) after the output is destroyed
+    size_t id() const { return id_; }
+
     // -- Overridden methods
     // None
 
@@ -93,7 +100,8 @@ protected:
 
 private:
     // -- Members
-    // None
+
+    const size_t id_;
 
     // -- Methods
     // None
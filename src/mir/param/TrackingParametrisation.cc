@@ -0,0 +1,154 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/param/TrackingParametrisation.h"
+
+#include <ostream>
+#include <typeinfo>
+
+#include "mir/util/Exceptions.h"
+
+
+namespace mir::param {
+
+
+TrackingParametrisation::TrackingParametrisation(const MIRParametrisation& target) :
+    target_(&target), recording_(false) {}
+
+
+TrackingParametrisation::~TrackingParametrisation() = default;
+
+
+void TrackingParametrisation::target(const MIRParametrisation& target) {
+    ASSERT(&target != this);
+    target_ = &target;
+}
+
+
+void TrackingParametrisation::record(bool recording) {
+    recording_ = recording;
+}
+
+
+bool TrackingParametrisation::matches(const MIRParametrisation& other) const {
+    for (const auto& [key, same] : records_) {
+        if (!same(other)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+template <class T>
+bool TrackingParametrisation::_get(const std::string& name, T& value) const {
+    ASSERT(target_ != nullptr);
+    const bool found = target_->get(name, value);
+
+    if (recording_) {
+        records_.emplace(typeid(T).name() + ("/" + name),
+                         [name, found, value](const MIRParametrisation& other) {
+                             T otherValue{};
+                             const bool otherFound = other.get(name, otherValue);
+                             return found == otherFound && (!found || value == otherValue);
+                         });
+    }
+
+    return found;
+}
+
+
+const MIRParametrisation& TrackingParametrisation::userParametrisation() const {
+    ASSERT(target_ != nullptr);
+    return target_->userParametrisation();
+}
+
+
+const MIRParametrisation& TrackingParametrisation::fieldParametrisation() const {
+    return *this;
+}
+
+
+void TrackingParametrisation::print(std::ostream& out) const {
+    out << "TrackingParametrisation[recorded=" << records_.size() << ",target=" << *target_ << "]";
+}
+
+
+bool TrackingParametrisation::has(const std::string& name) const {
+    ASSERT(target_ != nullptr);
+    const bool found = target_->has(name);
+
+    if (recording_) {
+        records_.emplace("has/" + name,
+                         [name, found](const MIRParametrisation& other) { return found == other.has(name); });
+    }
+
+    return found;
+}
+
+
+bool TrackingParametrisation::get(const std::string& name, std::string& value) const {
+    return _get(name, value);
+}
+
+
+bool TrackingParametrisation::get(const std::string& name, bool& value) const {
+    return _get(name, value);
+}
+
+
+bool TrackingParametrisation::get(const std::string& name, int& value) const {
+    return _get(name, value);
+}
+
+
+bool TrackingParametrisation::get(const std::string& name, long& value) const {
+    return _get(name, value);
+}
+
+
+bool TrackingParametrisation::get(const std::string& name, float& value) const {
+    return _get(name, value);
+}
+
+
+bool TrackingParametrisation::get(const std::string& name, double& value) const {
+    return _get(name, value);
+}
+
+
+bool TrackingParametrisation::get(const std::string& name, std::vector<int>& value) const {
+    return _get(name, value);
+}
+
+
+bool TrackingParametrisation::get(const std::string& name, std::vector<long>& value) const {
+    return _get(name, value);
+}
+
+
+bool TrackingParametrisation::get(const std::string& name, std::vector<float>& value) const {
+    return _get(name, value);
+}
+
+
+bool TrackingParametrisation::get(const std::string& name, std::vector<double>& value) const {
+    return _get(name, value);
+}
+
+
+bool TrackingParametrisation::get(const std::string& name, std::vector<std::string>& value) const {
+    return _get(name, value);
+}
+
+
+}  // namespace mir::param
@@ -0,0 +1,90 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+
+#include "mir/param/MIRParametrisation.h"
+
+
+namespace mir::param {
+
+
+/**
+ * Forwards to another parametrisation (which can be replaced), optionally recording the lookups and their results; this
+ * allows checking if another parametrisation answers the same to the recorded lookups (eg. to reuse objects built
+ * from the recorded one).
+ */
+class TrackingParametrisation : public MIRParametrisation {
+public:
+    // -- Constructors
+
+    explicit TrackingParametrisation(const MIRParametrisation&);
+
+    // -- Destructor
+
+    ~TrackingParametrisation() override;
+
+    // -- Methods
+
+    /// Forward to another parametrisation
+    void target(const MIRParametrisation&);
+
+    /// Start/stop recording lookups
+    void record(bool);
+
+    /// Same results for all recorded lookups
+    bool matches(const MIRParametrisation&) const;
+
+    size_t recorded() const { return records_.size(); }
+
+private:
+    // -- Members
+
+    const MIRParametrisation* target_;
+    bool recording_;
+    mutable std::map<std::string, std::function<bool(const MIRParametrisation&)>> records_;
+
+    // -- Methods
+
+    template <class T>
+    bool _get(const std::string&, T&) const;
+
+    // -- Overridden methods
+
+    const MIRParametrisation& userParametrisation() const override;
+    const MIRParametrisation& fieldParametrisation() const override;
+
+    // From MIRParametrisation
+    void print(std::ostream&) const override;
+
+    bool has(const std::string& name) const override;
+
+    bool get(const std::string& name, std::string& value) const override;
+    bool get(const std::string& name, bool& value) const override;
+    bool get(const std::string& name, int& value) const override;
+    bool get(const std::string& name, long& value) const override;
+    bool get(const std::string& name, float& value) const override;
+    bool get(const std::string& name, double& value) const override;
+
+    bool get(const std::string& name, std::vector<int>& value) const override;
+    bool get(const std::string& name, std::vector<long>& value) const override;
+    bool get(const std::string& name, std::vector<float>& value) const override;
+    bool get(const std::string& name, std::vector<double>& value) const override;
+    bool get(const std::string& name, std::vector<std::string>& value) const override;
+};
+
+
+}  // namespace mir::param
@@ -12,6 +12,11 @@
 
 #include "mir/search/PointSearch.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+
 #include "eckit/config/Resource.h"
 #include "eckit/thread/AutoLock.h"
 
@@ -28,6 +33,78 @@
 namespace mir::search {
 
 
+// 10 bits per coordinate, interleaved (Morton code)
+static std::uint32_t spread_bits(std::uint32_t x) {
+    x &= 0x3ff;
+    x = (x | (x << 16)) & 0x30000ff;
+    x = (x | (x << 8)) & 0x300f00f;
+    x = (x | (x << 4)) & 0x30c30c3;
+    x = (x | (x << 2)) & 0x9249249;
+    return x;
+}
+
+
+// Batch order along a Z-order curve in the points bounding box, so consecutive searches visit the same tree nodes
+static std::vector<size_t> spatial_order(const PointSearch::PointType* points, size_t count) {
+    std::vector<size_t> order(count);
+    if (count < 2) {
+        std::iota(order.begin(), order.end(), 0);
+        return order;
+    }
+
+    double min[3]{points[0][0], points[0][1], points[0][2]};
+    double max[3]{min[0], min[1], min[2]};
+    for (size_t i = 1; i < count; ++i) {
+        for (size_t d = 0; d < 3; ++d) {
+            min[d] = std::min(min[d], points[i][d]);
+            max[d] = std::max(max[d], points[i][d]);
+        }
+    }
+
+    double scale[3];
+    for (size_t d = 0; d < 3; ++d) {
+        scale[d] = max[d] > min[d] ? 1023. / (max[d] - min[d]) : 0.;
+    }
+
+    std::vector<std::pair<std::uint32_t, size_t>> codes(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::uint32_t code = 0;
+        for (size_t d = 0; d < 3; ++d) {
+            code |= spread_bits(static_cast<std::uint32_t>((points[i][d] - min[d]) * scale[d])) << d;
+        }
+        codes[i] = {code, i};
+    }
+
+    std::sort(codes.begin(), codes.end());
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = codes[i].second;
+    }
+
+    return order;
+}
+
+
+// Place results found in search order (point i at [start[i], start[i] + offsets[i + 1])) in batch order, and set
+// offsets to the cumulative counts
+template <typename T>
+static void batch_order(const std::vector<size_t>& start, const std::vector<T>& found, std::vector<size_t>& offsets,
+                        std::vector<T>& result) {
+    const auto count = start.size();
+    ASSERT(offsets.size() == count + 1);
+
+    for (size_t i = 0; i < count; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    result.clear();
+    result.reserve(found.size());
+    for (size_t i = 0; i < count; ++i) {
+        const auto len = offsets[i + 1] - offsets[i];
+        result.insert(result.end(), found.begin() + long(start[i]), found.begin() + long(start[i] + len));
+    }
+}
+
+
 static std::string extract_loader(const param::MIRParametrisation& param) {
     bool caching = LibMir::caching();
     param.get("caching", caching);
@@ -65,12 +142,93 @@ void PointSearch::closestNPoints(const PointType& pt, size_t n, std::vector<Poin
         return;
     }
 
-    closest = tree_->kNearestNeighbours(pt, n);
+    tree_->kNearestNeighbours(pt, n, closest);
 }
 
 
 void PointSearch::closestWithinRadius(const PointType& pt, double radius, std::vector<PointValueType>& closest) const {
-    closest = tree_->findInSphere(pt, radius);
+    tree_->findInSphere(pt, radius, closest);
+}
+
+
+void PointSearch::closestNPoints(const PointType* points, size_t count, size_t n, ValueType* indices,
+                                 double* distances) const {
+    ASSERT(n > 0);
+
+    for (auto i : spatial_order(points, count)) {
+        const auto found = tree_->kNearestNeighbours(points[i], n, indices + i * n, distances + i * n);
+        ASSERT(found == n);
+    }
+}
+
+
+void PointSearch::closestNPoints(const PointType* points, size_t count, size_t n,
+                                 std::vector<PointValueType>& closest) const {
+    ASSERT(n > 0);
+
+    // results in search order, then placed in batch order
+    std::vector<size_t> start(count);
+    std::vector<size_t> offsets(count + 1, n);
+    std::vector<PointValueType> found;
+    std::vector<PointValueType> nearest;
+    found.reserve(count * n);
+
+    offsets[0] = 0;
+    for (auto i : spatial_order(points, count)) {
+        start[i] = found.size();
+        closestNPoints(points[i], n, nearest);
+        ASSERT(nearest.size() == n);
+        found.insert(found.end(), nearest.begin(), nearest.end());
+    }
+
+    batch_order(start, found, offsets, closest);
+}
+
+
+void PointSearch::closestWithinRadius(const PointType* points, size_t count, double radius,
+                                      std::vector<size_t>& offsets, std::vector<ValueType>& indices,
+                                      std::vector<double>& distances) const {
+    // results in search order, then placed in batch order
+    std::vector<size_t> start(count);
+    std::vector<ValueType> found;
+    std::vector<double> foundDistances;
+    offsets.assign(count + 1, 0);
+
+    for (auto i : spatial_order(points, count)) {
+        start[i] = found.size();
+        tree_->findInSphere(points[i], radius, found, foundDistances);
+        offsets[i + 1] = found.size() - start[i];
+    }
+
+    auto sizes(offsets);
+    batch_order(start, found, offsets, indices);
+    batch_order(start, foundDistances, sizes, distances);
+}
+
+
+void PointSearch::closestWithinRadius(const PointType* points, size_t count, double radius,
+                                      std::vector<size_t>& offsets, std::vector<PointValueType>& closest) const {
+    // results in search order, then placed in batch order
+    std::vector<size_t> start(count);
+    std::vector<PointValueType> found;
+    std::vector<PointValueType> within;
+    offsets.assign(count + 1, 0);
+
+    for (auto i : spatial_order(points, count)) {
+        start[i] = found.size();
+        closestWithinRadius(points[i], radius, within);
+        found.insert(found.end(), within.begin(), within.end());
+        offsets[i + 1] = within.size();
+    }
+
+    batch_order(start, found, offsets, closest);
+}
+
+
+size_t PointSearch::batchSize() {
+    static const size_t size = eckit::Resource<size_t>("$MIR_POINT_SEARCH_BATCH_SIZE", 4096);
+    ASSERT(size > 0);
+    return size;
 }
 
 
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mir/search/Tree.h"
 
@@ -26,7 +27,6 @@ namespace mir::search {
 
 
 /// Class for fast searches in point clouds following k-d tree algorithms
-/// @todo test k-d tree stored in shared memory?
 class PointSearch {
 public:
     // -- Types
@@ -67,6 +67,25 @@ public:
     /// Finds closest points within a radius
     void closestWithinRadius(const PointType&, double radius, std::vector<PointValueType>& closest) const;
 
+    /// Finds closest N points to a batch of points, writing point i indices and distances (closest first) into
+    /// caller-owned arrays at [i * n, (i + 1) * n); the batch is searched in spatial order
+    void closestNPoints(const PointType* points, size_t count, size_t n, ValueType* indices, double* distances) const;
+
+    /// Finds closest N points to a batch of points, point i results (closest first) are at [i * n, (i + 1) * n)
+    void closestNPoints(const PointType* points, size_t count, size_t n, std::vector<PointValueType>& closest) const;
+
+    /// Finds closest points within a radius to a batch of points, point i results are at [offsets[i], offsets[i + 1])
+    /// of caller-owned arrays (resized, keeping their capacity); the batch is searched in spatial order
+    void closestWithinRadius(const PointType* points, size_t count, double radius, std::vector<size_t>& offsets,
+                             std::vector<ValueType>& indices, std::vector<double>& distances) const;
+
+    /// Finds closest points within a radius to a batch of points, point i results are at [offsets[i], offsets[i + 1])
+    void closestWithinRadius(const PointType* points, size_t count, double radius, std::vector<size_t>& offsets,
+                             std::vector<PointValueType>& closest) const;
+
+    /// Number of points per batch for callers searching many points, bounding the memory of batch results
+    static size_t batchSize();
+
     // -- Overridden methods
     // None
 
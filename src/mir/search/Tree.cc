@@ -68,14 +68,29 @@ Tree::PointValueType Tree::nearestNeighbour(const Point& /*unused*/) {
 }
 
 
-std::vector<Tree::PointValueType> Tree::kNearestNeighbours(const Point& /*unused*/, size_t /*unused*/) {
+void Tree::kNearestNeighbours(const Point& /*unused*/, size_t /*unused*/, std::vector<PointValueType>& /*unused*/) {
     std::ostringstream os;
     os << "Tree::kNearestNeighbours() not implemented for " << *this;
     throw exception::SeriousBug(os.str());
 }
 
 
-std::vector<Tree::PointValueType> Tree::findInSphere(const Point& /*unused*/, double /*unused*/) {
+void Tree::findInSphere(const Point& /*unused*/, double /*unused*/, std::vector<PointValueType>& /*unused*/) {
+    std::ostringstream os;
+    os << "Tree::findInSphere() not implemented for " << *this;
+    throw exception::SeriousBug(os.str());
+}
+
+
+size_t Tree::kNearestNeighbours(const Point& /*unused*/, size_t /*unused*/, Payload* /*unused*/, double* /*unused*/) {
+    std::ostringstream os;
+    os << "Tree::kNearestNeighbours() not implemented for " << *this;
+    throw exception::SeriousBug(os.str());
+}
+
+
+void Tree::findInSphere(const Point& /*unused*/, double /*unused*/, std::vector<Payload>& /*unused*/,
+                        std::vector<double>& /*unused*/) {
     std::ostringstream os;
     os << "Tree::findInSphere() not implemented for " << *this;
     throw exception::SeriousBug(os.str());
@@ -49,8 +49,14 @@ public:
     virtual void statsReset();
 
     virtual PointValueType nearestNeighbour(const Point&);
-    virtual std::vector<PointValueType> kNearestNeighbours(const Point&, size_t k);
-    virtual std::vector<PointValueType> findInSphere(const Point&, double);
+    virtual void kNearestNeighbours(const Point&, size_t k, std::vector<PointValueType>&);
+    virtual void findInSphere(const Point&, double, std::vector<PointValueType>&);
+
+    /// Writes (up to) k closest payloads/distances into caller-owned arrays, returns the number of entries written
+    virtual size_t kNearestNeighbours(const Point&, size_t k, Payload*, double*);
+
+    /// Appends payloads/distances within a radius to caller-owned arrays
+    virtual void findInSphere(const Point&, double, std::vector<Payload>&, std::vector<double>&);
 
     virtual bool ready() const;
     virtual void commit();
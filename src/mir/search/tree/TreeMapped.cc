@@ -42,21 +42,46 @@ Tree::PointValueType TreeMapped::nearestNeighbour(const Tree::Point& pt) {
 }
 
 
-std::vector<Tree::PointValueType> TreeMapped::kNearestNeighbours(const Tree::Point& pt, size_t k) {
-    std::vector<PointValueType> result;
+void TreeMapped::kNearestNeighbours(const Tree::Point& pt, size_t k, std::vector<PointValueType>& result) {
+    result.clear();
     for (const auto& n : tree_.kNearestNeighbours(pt, k)) {
-        result.emplace_back(PointValueType(n.point(), n.payload()));
+        result.emplace_back(n.point(), n.payload());
     }
-    return result;
 }
 
 
-std::vector<Tree::PointValueType> TreeMapped::findInSphere(const Tree::Point& pt, double radius) {
-    std::vector<PointValueType> result;
+void TreeMapped::findInSphere(const Tree::Point& pt, double radius, std::vector<PointValueType>& result) {
+    result.clear();
     for (const auto& n : tree_.findInSphere(pt, radius)) {
-        result.emplace_back(PointValueType(n.point(), n.payload()));
+        result.emplace_back(n.point(), n.payload());
+    }
+}
+
+
+size_t TreeMapped::kNearestNeighbours(const Tree::Point& pt, size_t k, Payload* payloads, double* distances) {
+    if (k == 1) {
+        const auto& nn = tree_.nearestNeighbour(pt);
+        payloads[0]    = nn.payload();
+        distances[0]   = nn.distance();
+        return 1;
+    }
+
+    size_t i = 0;
+    for (const auto& n : tree_.kNearestNeighbours(pt, k)) {
+        payloads[i]  = n.payload();
+        distances[i] = n.distance();
+        ++i;
+    }
+    return i;
+}
+
+
+void TreeMapped::findInSphere(const Tree::Point& pt, double radius, std::vector<Payload>& payloads,
+                              std::vector<double>& distances) {
+    for (const auto& n : tree_.findInSphere(pt, radius)) {
+        payloads.push_back(n.payload());
+        distances.push_back(n.distance());
     }
-    return result;
 }
 
 
@@ -12,6 +12,11 @@
 
 #include "mir/search/tree/TreeMappedFile.h"
 
+#include <set>
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
 #include "eckit/filesystem/PathExpander.h"
 #include "eckit/utils/Tokenizer.h"
 
@@ -19,6 +24,7 @@
 #include "mir/repres/Representation.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Log.h"
+#include "mir/util/Mutex.h"
 
 
 namespace mir::search::tree {
@@ -126,4 +132,105 @@ public:
 static const TreeBuilder<TreeMappedTempFile> builder2("mapped-temporary-file");
 
 
+// Lock taken before the tree file is chosen, so processes starting together wait for the first one to build the tree
+// and then map it, instead of building their own
+class SharedMemoryLock {
+protected:
+    explicit SharedMemoryLock(const eckit::PathName& path) : semaphore_(path) {
+        Log::debug() << "Wait for lock " << path << std::endl;
+        semaphore_.lock();
+        locked_ = true;
+        Log::debug() << "Got lock " << path << std::endl;
+    }
+
+    ~SharedMemoryLock() {
+        if (locked_) {
+            semaphore_.unlock();
+        }
+    }
+
+    eckit::Semaphore semaphore_;
+    bool locked_ = false;
+};
+
+
+// Tree files on a memory-backed file system (tmpfs), mapped shared: the first process on a node builds the tree, the
+// others map the same pages, so the tree memory is paid once per node. Trees are not evicted, they stay in memory until
+// removed (or the node reboots); the temporary files of builders that did not finish are removed by the next process
+// mapping the same tree
+class TreeMappedSharedMemory : private SharedMemoryLock, public TreeMappedFile<TreeMappedSharedMemory> {
+    using P = TreeMappedFile<TreeMappedSharedMemory>;
+
+    void lock() override {
+        if (!locked_) {
+            semaphore_.lock();
+            locked_ = true;
+        }
+    }
+
+    void unlock() override {
+        if (locked_) {
+            locked_ = false;
+            semaphore_.unlock();
+        }
+    }
+
+    void print(std::ostream& out) const override {
+        out << "TreeMappedSharedMemory["
+               "path="
+            << path_ << ",ready?" << ready() << "]";
+    }
+
+    // the lock is held, so other temporary files for this tree are left over by builders that did not finish; checked
+    // once per process and tree, when first mapped
+    void removeStaleFiles() const {
+        static util::recursive_mutex mutex;
+        static std::set<std::string> checked;
+
+        if (util::lock_guard<util::recursive_mutex> guard(mutex); !checked.insert(real_.asString()).second) {
+            return;
+        }
+
+        const auto prefix = real_.baseName().asString() + ".";
+        const auto lock   = prefix + "lock";
+        const auto own    = path_.baseName().asString();
+
+        std::vector<eckit::PathName> files;
+        std::vector<eckit::PathName> dirs;
+        real_.dirName().children(files, dirs);
+
+        for (const auto& file : files) {
+            const auto name = file.baseName().asString();
+            if (name.rfind(prefix, 0) == 0 && name != own && name != lock) {
+                Log::warning() << "TreeMappedSharedMemory: removing stale '" << file << "'" << std::endl;
+                file.unlink(false);
+            }
+        }
+    }
+
+    static eckit::PathName sharedLockFile(const repres::Representation& r) {
+        eckit::AutoUmask umask(0);
+
+        // the tree directory might not exist yet
+        auto path = treePath(r, false);
+        path.dirName().mkdir(0777);
+        return lockFile(path);
+    }
+
+public:
+    explicit TreeMappedSharedMemory(const repres::Representation& r) : SharedMemoryLock(sharedLockFile(r)), P(r) {
+        removeStaleFiles();
+    }
+
+    static std::vector<std::string> roots() {
+        static std::vector<std::string> _root{
+            eckit::Resource<std::string>("$MIR_POINT_SEARCH_SHARED_MEMORY_PATH", "/dev/shm")};
+        return _root;
+    }
+};
+
+
+static const TreeBuilder<TreeMappedSharedMemory> builder3("shared-memory");
+
+
 }  // namespace mir::search::tree
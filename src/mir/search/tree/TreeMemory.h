@@ -35,9 +35,13 @@ protected:
 
     PointValueType nearestNeighbour(const Tree::Point&) override;
 
-    std::vector<PointValueType> kNearestNeighbours(const Point&, size_t k) override;
+    void kNearestNeighbours(const Point&, size_t k, std::vector<PointValueType>&) override;
 
-    std::vector<PointValueType> findInSphere(const Point&, double radius) override;
+    void findInSphere(const Point&, double radius, std::vector<PointValueType>&) override;
+
+    size_t kNearestNeighbours(const Point&, size_t k, Payload*, double*) override;
+
+    void findInSphere(const Point&, double radius, std::vector<Payload>&, std::vector<double>&) override;
 
     bool ready() const override;
 
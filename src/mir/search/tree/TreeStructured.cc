@@ -0,0 +1,345 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/search/tree/TreeStructured.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <ostream>
+
+#include "mir/repres/Iterator.h"
+#include "mir/repres/Representation.h"
+#include "mir/util/Angles.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Log.h"
+
+
+namespace mir::search::tree {
+
+
+TreeStructured::TreeStructured(const repres::Representation& r) : TreeMemory(r) {
+    if (!detect(r)) {
+        rings_.clear();
+        Log::debug() << "TreeStructured: " << r << " is not made of global latitude rings, using a k-d tree"
+                     << std::endl;
+    }
+}
+
+
+bool TreeStructured::detect(const repres::Representation& r) {
+    constexpr double EPS_LAT = 1e-9;
+    constexpr double EPS_LON = 1e-6;
+
+    // close ring, checking it is global
+    auto close = [this](double dlon) {
+        auto& ring = rings_.back();
+        if (ring.n > 1 && std::abs(double(ring.n) * dlon - 360.) > EPS_LON) {
+            return false;
+        }
+        ring.dlon = 360. / double(ring.n);
+        return true;
+    };
+
+    // rings of regularly spaced points, west to east, indexed contiguously
+    size_t count = 0;
+    double dlon  = 0.;
+
+    for (const std::unique_ptr<repres::Iterator> it(r.iterator()); it->next(); ++count) {
+        if (it->index() != count) {
+            return false;
+        }
+
+        const auto& p    = *(*it);
+        const double lat = p[0];
+        const double lon = p[1];
+
+        if (count == 0) {
+            const auto q = it->point3D();
+            radius_      = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+        }
+
+        if (rings_.empty() || std::abs(lat - rings_.back().lat) > EPS_LAT) {
+            if (!rings_.empty() && !close(dlon)) {
+                return false;
+            }
+            rings_.push_back({lat, lon, 0., 0., 0., 1, count});
+            continue;
+        }
+
+        auto& ring = rings_.back();
+        if (ring.n == 1) {
+            dlon = lon - ring.lon0;
+            if (!(dlon > 0.)) {
+                return false;
+            }
+        }
+
+        if (std::abs(std::remainder(lon - ring.lon0 - double(ring.n) * dlon, 360.)) > EPS_LON) {
+            return false;
+        }
+
+        ring.n++;
+    }
+
+    if (rings_.empty() || !close(dlon) || count != itemCount()) {
+        return false;
+    }
+
+    // rings north to south, each latitude once
+    std::sort(rings_.begin(), rings_.end(), [](const Ring& a, const Ring& b) { return a.lat > b.lat; });
+    for (size_t j = 1; j < rings_.size(); ++j) {
+        if (rings_[j - 1].lat - rings_[j].lat <= EPS_LAT) {
+            return false;
+        }
+    }
+
+    for (auto& ring : rings_) {
+        ring.lat    = util::degree_to_radian(ring.lat);
+        ring.lon0   = util::degree_to_radian(ring.lon0);
+        ring.dlon   = util::degree_to_radian(ring.dlon);
+        ring.sinLat = std::sin(ring.lat);
+        ring.cosLat = std::cos(ring.lat);
+    }
+
+    return true;
+}
+
+
+void TreeStructured::search(const Point& p, size_t k, double radius, std::vector<Candidate>& found) const {
+    found.clear();
+
+    // target point (not necessarily on the grid sphere)
+    const double r     = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+    const double rxy   = std::sqrt(p[0] * p[0] + p[1] * p[1]);
+    const double lat   = std::atan2(p[2], rxy);
+    const double lon   = std::atan2(p[1], p[0]);
+    const double cosL  = std::cos(lat);
+    const double dr2   = (r - radius_) * (r - radius_);
+    const double fourR = 4. * r * radius_;
+
+    // squared chord (haversine form), not negative for close points unlike R^2 + r^2 - 2 R r cos(angle)
+    auto hav = [](double angle) {
+        const double s = std::sin(angle / 2.);
+        return s * s;
+    };
+
+    constexpr double INF = std::numeric_limits<double>::infinity();
+    const double radius2 = radius * radius;
+
+    // squared distance to accept candidates (k-nearest: k-th closest so far, otherwise: radius)
+    auto threshold = [&]() { return k == 0 ? radius2 : found.size() < k ? INF : found.front().d2; };
+
+    auto add = [&](const Candidate& c) {
+        if (k == 0) {
+            found.push_back(c);
+        }
+        else if (found.size() < k) {
+            found.push_back(c);
+            std::push_heap(found.begin(), found.end());
+        }
+        else if (c < found.front()) {
+            std::pop_heap(found.begin(), found.end());
+            found.back() = c;
+            std::push_heap(found.begin(), found.end());
+        }
+    };
+
+    // distance grows with the longitude difference (up to half a turn) on a ring, and with the latitude difference
+    // across rings, so points are visited outwards until no closer point can be found
+    auto sweep = [&](size_t j) {
+        const auto& ring = rings_[j];
+        const auto n     = static_cast<long long>(ring.n);
+        const auto west  = (static_cast<long long>(std::floor((lon - ring.lon0) / ring.dlon)) % n + n) % n;
+        const double h   = hav(lat - ring.lat);
+        const double c   = cosL * ring.cosLat;
+
+        auto visit = [&](long long i) {
+            const double dlon = lon - ring.lon0 - double(i) * ring.dlon;
+            const double d2   = dr2 + fourR * (h + c * hav(dlon));
+            if (d2 > threshold()) {
+                return false;
+            }
+            add({d2, j, size_t(i)});
+            return true;
+        };
+
+        long long visited = 0;
+        for (auto i = west; visited < n && visit(i); i = (i + n - 1) % n) {
+            ++visited;
+        }
+        for (auto i = (west + 1) % n; visited < n && visit(i); i = (i + 1) % n) {
+            ++visited;
+        }
+    };
+
+    auto bound = [&](size_t j) { return dr2 + fourR * hav(lat - rings_[j].lat); };
+
+    auto start = std::lower_bound(rings_.begin(), rings_.end(), lat,
+                                  [](const Ring& ring, double value) { return ring.lat > value; });
+    auto north = size_t(start - rings_.begin());
+    auto south = north;
+
+    while (true) {
+        const double bn = north > 0 ? bound(north - 1) : INF;
+        const double bs = south < rings_.size() ? bound(south) : INF;
+        if (bn == INF && bs == INF) {
+            break;
+        }
+
+        if (std::min(bn, bs) > threshold()) {
+            break;
+        }
+
+        if (bn < bs) {
+            sweep(--north);
+        }
+        else {
+            sweep(south++);
+        }
+    }
+
+    // closest first
+    if (k == 0) {
+        std::sort(found.begin(), found.end());
+    }
+    else {
+        std::sort_heap(found.begin(), found.end());
+    }
+}
+
+
+TreeStructured::Point TreeStructured::point(const Candidate& c) const {
+    const auto& ring = rings_[c.ring];
+    const double lon = ring.lon0 + double(c.i) * ring.dlon;
+    return {radius_ * ring.cosLat * std::cos(lon), radius_ * ring.cosLat * std::sin(lon), radius_ * ring.sinLat};
+}
+
+
+void TreeStructured::statsPrint(std::ostream& out, bool pretty) {
+    if (rings_.empty()) {
+        TreeMemory::statsPrint(out, pretty);
+        return;
+    }
+    out << "TreeStructured[rings=" << rings_.size() << "]";
+}
+
+
+void TreeStructured::statsReset() {
+    if (rings_.empty()) {
+        TreeMemory::statsReset();
+    }
+}
+
+
+Tree::PointValueType TreeStructured::nearestNeighbour(const Tree::Point& pt) {
+    if (rings_.empty()) {
+        return TreeMemory::nearestNeighbour(pt);
+    }
+
+    thread_local std::vector<Candidate> found;
+    search(pt, 1, 0., found);
+    ASSERT(found.size() == 1);
+
+    return {point(found.front()), payload(found.front())};
+}
+
+
+void TreeStructured::kNearestNeighbours(const Tree::Point& pt, size_t k, std::vector<PointValueType>& result) {
+    if (rings_.empty()) {
+        TreeMemory::kNearestNeighbours(pt, k, result);
+        return;
+    }
+
+    thread_local std::vector<Candidate> found;
+    search(pt, k, 0., found);
+
+    result.clear();
+    for (const auto& c : found) {
+        result.emplace_back(point(c), payload(c));
+    }
+}
+
+
+void TreeStructured::findInSphere(const Tree::Point& pt, double radius, std::vector<PointValueType>& result) {
+    if (rings_.empty()) {
+        TreeMemory::findInSphere(pt, radius, result);
+        return;
+    }
+
+    thread_local std::vector<Candidate> found;
+    search(pt, 0, radius, found);
+
+    result.clear();
+    for (const auto& c : found) {
+        result.emplace_back(point(c), payload(c));
+    }
+}
+
+
+size_t TreeStructured::kNearestNeighbours(const Tree::Point& pt, size_t k, Payload* payloads, double* distances) {
+    if (rings_.empty()) {
+        return TreeMemory::kNearestNeighbours(pt, k, payloads, distances);
+    }
+
+    thread_local std::vector<Candidate> found;
+    search(pt, k, 0., found);
+
+    size_t i = 0;
+    for (const auto& c : found) {
+        payloads[i]  = payload(c);
+        distances[i] = std::sqrt(c.d2);
+        ++i;
+    }
+    return i;
+}
+
+
+void TreeStructured::findInSphere(const Tree::Point& pt, double radius, std::vector<Payload>& payloads,
+                                  std::vector<double>& distances) {
+    if (rings_.empty()) {
+        TreeMemory::findInSphere(pt, radius, payloads, distances);
+        return;
+    }
+
+    thread_local std::vector<Candidate> found;
+    search(pt, 0, radius, found);
+
+    for (const auto& c : found) {
+        payloads.push_back(payload(c));
+        distances.push_back(std::sqrt(c.d2));
+    }
+}
+
+
+bool TreeStructured::ready() const {
+    return !rings_.empty();
+}
+
+
+void TreeStructured::print(std::ostream& out) const {
+    out << "TreeStructured[";
+    if (rings_.empty()) {
+        TreeMemory::print(out);
+    }
+    else {
+        out << "rings=" << rings_.size();
+    }
+    out << "]";
+}
+
+
+static const TreeBuilder<TreeStructured> builder("structured");
+
+
+}  // namespace mir::search::tree
@@ -0,0 +1,82 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <tuple>
+#include <vector>
+
+#include "mir/search/tree/TreeMemory.h"
+
+
+namespace mir::search::tree {
+
+
+/**
+ * Search of grids made of global latitude rings of regularly spaced points (regular lat/lon, regular and reduced
+ * Gaussian, HEALPix ring ordering) from the grid geometry, visiting rings outwards from the target latitude, and ring
+ * points outwards from the target longitude; there is no tree to build. Other grids fall back to a k-d tree in memory.
+ */
+class TreeStructured : public TreeMemory {
+    struct Ring {
+        double lat;
+        double lon0;
+        double dlon;
+        double sinLat;
+        double cosLat;
+        size_t n;
+        size_t first;
+    };
+
+    struct Candidate {
+        double d2;
+        size_t ring;
+        size_t i;
+        bool operator<(const Candidate& other) const {
+            return std::tie(d2, ring, i) < std::tie(other.d2, other.ring, other.i);
+        }
+    };
+
+    std::vector<Ring> rings_;
+    double radius_ = 0.;
+
+    bool detect(const repres::Representation&);
+
+    void search(const Point&, size_t k, double radius, std::vector<Candidate>&) const;
+
+    Payload payload(const Candidate& c) const { return rings_[c.ring].first + c.i; }
+    Point point(const Candidate&) const;
+
+    void statsPrint(std::ostream&, bool pretty) override;
+
+    void statsReset() override;
+
+    PointValueType nearestNeighbour(const Tree::Point&) override;
+
+    void kNearestNeighbours(const Point&, size_t k, std::vector<PointValueType>&) override;
+
+    void findInSphere(const Point&, double radius, std::vector<PointValueType>&) override;
+
+    size_t kNearestNeighbours(const Point&, size_t k, Payload*, double*) override;
+
+    void findInSphere(const Point&, double radius, std::vector<Payload>&, std::vector<double>&) override;
+
+    bool ready() const override;
+
+    void print(std::ostream&) const override;
+
+public:
+    TreeStructured(const repres::Representation&);
+};
+
+
+}  // namespace mir::search::tree
@@ -13,6 +13,7 @@
 #include "mir/util/GlobaliseUnstructured.h"
 
 #include <memory>
+#include <vector>
 
 #include "mir/key/grid/Grid.h"
 #include "mir/param/MIRParametrisation.h"
@@ -61,14 +62,27 @@ size_t GlobaliseUnstructured::appendGlobalPoints(std::vector<double>& latitudes,
     size_t nbExtraPoints = 0;
 
 
-    // insert global grid points when distant enough from provided grid points
+    // search global grid points (in batch)
+    std::vector<Point3> points;
+    std::vector<PointLatLon> unrotated;
+    points.reserve(globe->numberOfPoints());
+    unrotated.reserve(globe->numberOfPoints());
+
     for (const std::unique_ptr<repres::Iterator> it(globe->iterator()); it->next();) {
-        const Point3 p(it->point3D());
-        if (Point3::distance(p, tree.closestPoint(p).point()) > globaliseMissingRadius_) {
+        points.emplace_back(it->point3D());
+        unrotated.emplace_back(it->pointUnrotated());
+    }
 
-            const auto& unrotated = it->pointUnrotated();
-            latitudes.push_back(unrotated.lat().value());
-            longitudes.push_back(unrotated.lon().value());
+    std::vector<search::PointSearch::ValueType> indices(points.size());
+    std::vector<double> distances(points.size());
+    tree.closestNPoints(points.data(), points.size(), 1, indices.data(), distances.data());
+
+
+    // insert global grid points when distant enough from provided grid points
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (distances[i] > globaliseMissingRadius_) {
+            latitudes.push_back(unrotated[i].lat().value());
+            longitudes.push_back(unrotated[i].lon().value());
             ++nbExtraPoints;
         }
     }
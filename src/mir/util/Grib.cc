@@ -85,44 +85,27 @@ void grib_reorder(std::vector<double>& values, const std::string& order, size_t
     ASSERT(Nj > 0);
     ASSERT(values.size() == Ni * Nj);
 
-    std::vector<double> out(values.size());
-
+    // reorders are in place (rows swapped and/or reversed), no buffer is allocated
     if (scanningMode == jScansPositively) {
         Log::warning() << "LatLon::reorder " << current << " to " << canonical << std::endl;
-        size_t count = 0;
-        for (size_t j = Nj; j > 0; --j) {
-            for (size_t i = 0; i < Ni; ++i) {
-                out[count++] = values[(j - 1) * Ni + i];
-            }
+        for (size_t j = 0; j < Nj / 2; ++j) {
+            std::swap_ranges(values.begin() + long(j * Ni), values.begin() + long((j + 1) * Ni),
+                             values.begin() + long((Nj - 1 - j) * Ni));
         }
-        ASSERT(count == out.size());
-        std::swap(values, out);
         return;
     }
 
     if (scanningMode == iScansNegatively) {
         Log::warning() << "LatLon::reorder " << current << " to " << canonical << std::endl;
-        size_t count = 0;
         for (size_t j = 0; j < Nj; ++j) {
-            for (size_t i = Ni; i > 0; --i) {
-                out[count++] = values[j * Ni + (i - 1)];
-            }
+            std::reverse(values.begin() + long(j * Ni), values.begin() + long((j + 1) * Ni));
         }
-        ASSERT(count == out.size());
-        std::swap(values, out);
         return;
     }
 
     if (scanningMode == (iScansNegatively | jScansPositively)) {
         Log::warning() << "LatLon::reorder " << current << " to " << canonical << std::endl;
-        size_t count = 0;
-        for (size_t j = Nj; j > 0; --j) {
-            for (size_t i = Ni; i > 0; --i) {
-                out[count++] = values[(j - 1) * Ni + (i - 1)];
-            }
-        }
-        ASSERT(count == out.size());
-        std::swap(values, out);
+        std::reverse(values.begin(), values.end());
         return;
     }
 
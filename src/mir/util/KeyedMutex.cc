@@ -0,0 +1,59 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/util/KeyedMutex.h"
+
+#include "mir/util/Exceptions.h"
+
+
+namespace mir::util {
+
+
+KeyedMutex::Lock::Lock(KeyedMutex& owner, const std::string& key) :
+    owner_(owner), key_(key), mutex_(owner.acquire(key)) {
+    mutex_.lock();
+}
+
+
+KeyedMutex::Lock::~Lock() {
+    mutex_.unlock();
+    owner_.release(key_);
+}
+
+
+recursive_mutex& KeyedMutex::acquire(const std::string& key) {
+    lock_guard<recursive_mutex> lock(mutex_);
+
+    auto& entry = entries_[key];
+    if (!entry) {
+        entry = std::make_unique<Entry>();
+    }
+
+    entry->users++;
+    return entry->mutex;
+}
+
+
+void KeyedMutex::release(const std::string& key) {
+    lock_guard<recursive_mutex> lock(mutex_);
+
+    auto entry = entries_.find(key);
+    ASSERT(entry != entries_.end());
+    ASSERT(entry->second->users > 0);
+
+    if (--(entry->second->users) == 0) {
+        entries_.erase(entry);
+    }
+}
+
+
+}  // namespace mir::util
@@ -0,0 +1,88 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "mir/util/Mutex.h"
+
+
+namespace mir::util {
+
+
+/**
+ * Mutual exclusion per key ("single-flight"): threads locking the same key wait for the first one (eg. creating a
+ * cache entry), threads locking other keys are not blocked. Locks are recursive, and released per-key entries are
+ * removed.
+ */
+class KeyedMutex {
+public:
+    // -- Types
+
+    class Lock {
+    public:
+        Lock(KeyedMutex&, const std::string& key);
+
+        Lock(const Lock&) = delete;
+        Lock(Lock&&)      = delete;
+
+        ~Lock();
+
+        void operator=(const Lock&) = delete;
+        void operator=(Lock&&)      = delete;
+
+    private:
+        KeyedMutex& owner_;
+        const std::string key_;
+        recursive_mutex& mutex_;
+    };
+
+    // -- Constructors
+
+    KeyedMutex() = default;
+
+    KeyedMutex(const KeyedMutex&) = delete;
+    KeyedMutex(KeyedMutex&&)      = delete;
+
+    // -- Destructor
+
+    ~KeyedMutex() = default;
+
+    // -- Operators
+
+    void operator=(const KeyedMutex&) = delete;
+    void operator=(KeyedMutex&&)      = delete;
+
+private:
+    // -- Types
+
+    struct Entry {
+        recursive_mutex mutex;
+        size_t users = 0;
+    };
+
+    // -- Members
+
+    recursive_mutex mutex_;
+    std::map<std::string, std::unique_ptr<Entry>> entries_;
+
+    // -- Methods
+
+    recursive_mutex& acquire(const std::string& key);
+    void release(const std::string& key);
+};
+
+
+}  // namespace mir::util
@@ -23,7 +23,9 @@
 namespace mir::util {
 
 
-static const std::vector<std::string> all_caches{"mirBitmap", "mirArea", "mirCoefficient", "mirMatrix", "mirMesh"};
+static const std::vector<std::string> all_caches{
+    "mirBitmap",         "mirArea",          "mirCoefficient",           "mirMatrix",
+    "mirMatrixAdjusted", "mirMatrixReorder", "mirMatrixSinglePrecision", "mirMesh"};
 
 
 static const std::vector<std::pair<std::string, std::string>> all_timings{
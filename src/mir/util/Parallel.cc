@@ -0,0 +1,93 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "mir/util/Parallel.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "mir/api/mir_config.h"
+#include "mir/param/MIRParametrisation.h"
+
+
+extern "C" {
+void omp_set_num_threads(int);
+}
+
+
+namespace mir::util {
+
+
+size_t parallel_num_threads(const param::MIRParametrisation& param) {
+    size_t threads = 1;
+    param.get("parallel-omp-num-threads", threads);
+    return std::max<size_t>(threads, 1);
+}
+
+
+void parallel_omp_num_threads(const param::MIRParametrisation& param) {
+    if constexpr (MIR_HAVE_OMP) {
+        int num_threads = 1;
+        if (param.get("parallel-omp-num-threads", num_threads)) {
+            omp_set_num_threads(num_threads);
+        }
+    }
+}
+
+
+size_t parallel_for_blocks(size_t size, size_t threads, const std::function<void(size_t, size_t, size_t)>& func) {
+    const auto blocks = std::max<size_t>(1, std::min(threads, size));
+    const auto chunk  = size / blocks;
+    const auto extra  = size % blocks;
+
+    auto begin = [chunk, extra](size_t b) { return b * chunk + std::min(b, extra); };
+
+    if (blocks == 1) {
+        func(0, 0, size);
+        return 1;
+    }
+
+    std::vector<std::exception_ptr> errors(blocks);
+    auto run = [&](size_t b) {
+        try {
+            func(b, begin(b), begin(b + 1));
+        }
+        catch (...) {
+            errors[b] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(blocks - 1);
+    for (size_t b = 1; b < blocks; ++b) {
+        pool.emplace_back(run, b);
+    }
+
+    run(0);
+
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    for (const auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+
+    return blocks;
+}
+
+
+}  // namespace mir::util
@@ -0,0 +1,47 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+
+namespace mir::param {
+class MIRParametrisation;
+}  // namespace mir::param
+
+
+namespace mir::util {
+
+
+/// Number of threads for parallel regions ("parallel-omp-num-threads", default 1)
+size_t parallel_num_threads(const param::MIRParametrisation&);
+
+
+/// Set number of threads for OpenMP parallel regions, if configured ("parallel-omp-num-threads") and supported
+void parallel_omp_num_threads(const param::MIRParametrisation&);
+
+
+/**
+ * Partition [0, size) into (at most) threads contiguous blocks, in order, and process each block on its own thread
+ * (the calling thread processes the first block). The first exception thrown by any block is re-thrown after all
+ * threads have joined.
+ * @param size range size
+ * @param threads maximum number of threads/blocks
+ * @param func function(block, begin, end), with block in [0, blocks)
+ * @return number of blocks
+ */
+size_t parallel_for_blocks(size_t size, size_t threads, const std::function<void(size_t, size_t, size_t)>& func);
+
+
+}  // namespace mir::util
@@ -12,16 +12,23 @@
 
 #include "mir/util/Reorder.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <numeric>
 #include <ostream>
+#include <utility>
 
 #include "eckit/geo/order/HEALPix.h"
 #include "eckit/log/JSON.h"
 
+#include "mir/repres/Iterator.h"
+#include "mir/repres/Representation.h"
 #include "mir/util/Exceptions.h"
 #include "mir/util/Mutex.h"
+#include "mir/util/Types.h"
 
 
 namespace mir::util {
@@ -88,9 +95,114 @@ public:
 };
 
 
+/// Order points along a space-filling curve over (longitude, latitude), so that nearby points get nearby indices
+class SpaceFillingCurve : public Reorder {
+public:
+    using Reorder::Reorder;
+
+    std::vector<size_t> reorder() override {
+        throw exception::UserError("Reorder: '" + name + "' requires point coordinates");
+    }
+
+    std::vector<size_t> reorder(const repres::Representation& rep) override {
+        ASSERT(rep.numberOfPoints() == size);
+
+        // curve index on a grid of 2^16 by 2^16 cells
+        constexpr auto N = static_cast<std::uint32_t>(1U << 16);
+
+        auto cell = [](double x, double range) {
+            auto c = static_cast<std::int64_t>(x / range * static_cast<double>(N));
+            return static_cast<std::uint32_t>(std::min<std::int64_t>(std::max<std::int64_t>(c, 0), N - 1));
+        };
+
+        std::vector<std::pair<std::uint64_t, size_t>> keys;
+        keys.reserve(size);
+
+        for (const std::unique_ptr<repres::Iterator> it(rep.iterator()); it->next();) {
+            const auto& p = it->pointUnrotated();
+            auto x        = cell(p.lon().normalise(Longitude::GREENWICH).value(), 360.);
+            auto y        = cell(p.lat().value() + 90., 180.);
+            keys.emplace_back(index(x, y, N), it->index());
+        }
+
+        ASSERT(keys.size() == size);
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<size_t> order(size);
+        for (size_t k = 0; k < size; ++k) {
+            ASSERT(keys[k].second < size);
+            order[keys[k].second] = k;
+        }
+
+        return order;
+    }
+
+private:
+    virtual std::uint64_t index(std::uint32_t x, std::uint32_t y, std::uint32_t n) const = 0;
+};
+
+
+class Hilbert final : public SpaceFillingCurve {
+public:
+    using SpaceFillingCurve::SpaceFillingCurve;
+
+    void print(std::ostream& s) const override { s << "Hilbert[]"; }
+
+private:
+    std::uint64_t index(std::uint32_t x, std::uint32_t y, std::uint32_t n) const override {
+        std::uint64_t d = 0;
+        for (auto s = n / 2; s > 0; s /= 2) {
+            std::uint32_t rx = (x & s) > 0 ? 1 : 0;
+            std::uint32_t ry = (y & s) > 0 ? 1 : 0;
+            d += static_cast<std::uint64_t>(s) * s * ((3 * rx) ^ ry);
+
+            // rotate quadrant
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = n - 1 - x;
+                    y = n - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+};
+
+
+class Morton final : public SpaceFillingCurve {
+public:
+    using SpaceFillingCurve::SpaceFillingCurve;
+
+    void print(std::ostream& s) const override { s << "Morton[]"; }
+
+private:
+    static std::uint64_t spread(std::uint64_t v) {
+        v = (v | (v << 16)) & 0x0000ffff0000ffffULL;
+        v = (v | (v << 8)) & 0x00ff00ff00ff00ffULL;
+        v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        v = (v | (v << 2)) & 0x3333333333333333ULL;
+        v = (v | (v << 1)) & 0x5555555555555555ULL;
+        return v;
+    }
+
+    std::uint64_t index(std::uint32_t x, std::uint32_t y, std::uint32_t /*unused*/) const override {
+        return spread(x) | (spread(y) << 1);
+    }
+};
+
+
 static const Reorder::BuilderT<HEALPixRingToNested> REORDER1("healpix-ring-to-nested");
 static const Reorder::BuilderT<HEALPixNestedToRing> REORDER2("healpix-nested-to-ring");
 static const Reorder::BuilderT<Identity> REORDER3("identity");
+static const Reorder::BuilderT<Hilbert> REORDER4("hilbert");
+static const Reorder::BuilderT<Morton> REORDER5("morton");
+
+
+std::vector<size_t> Reorder::reorder(const repres::Representation& rep) {
+    ASSERT(rep.numberOfPoints() == size);
+    return reorder();
+}
 
 
 Reorder* Reorder::build(const std::string& name, size_t size) {
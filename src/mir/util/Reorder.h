@@ -10,6 +10,8 @@
  */
 
 
+#pragma once
+
 #include <iosfwd>
 #include <string>
 #include <vector>
@@ -19,6 +21,10 @@ namespace eckit {
 class JSON;
 }
 
+namespace mir::repres {
+class Representation;
+}
+
 
 namespace mir::util {
 
@@ -62,6 +68,9 @@ public:
 
     virtual std::vector<size_t> reorder() = 0;
 
+    /// Reordering of representation points, by default independent of their coordinates
+    virtual std::vector<size_t> reorder(const repres::Representation&);
+
     // -- Members
 
     const std::string name;
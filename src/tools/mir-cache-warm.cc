@@ -0,0 +1,218 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/option/CmdArgs.h"
+#include "eckit/option/SimpleOption.h"
+
+#include "mir/api/MIRJob.h"
+#include "mir/input/GribMemoryInput.h"
+#include "mir/input/MIRInput.h"
+#include "mir/output/EmptyOutput.h"
+#include "mir/param/ConfigurationWrapper.h"
+#include "mir/repres/Representation.h"
+#include "mir/tools/MIRTool.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Grib.h"
+#include "mir/util/Log.h"
+#include "mir/util/MIRStatistics.h"
+#include "mir/util/Mutex.h"
+#include "mir/util/Trace.h"
+
+
+namespace mir::tools {
+
+
+struct MIRCacheWarm : MIRTool {
+    MIRCacheWarm(int argc, char** argv) : MIRTool(argc, argv) {
+        using eckit::option::SimpleOption;
+
+        options_.push_back(
+            new SimpleOption<std::string>("request", "Post-processing options (as '--key=value ...') for all fields"));
+        options_.push_back(new SimpleOption<std::string>(
+            "requests", "File of post-processing options (as '--key=value ...'), one request per line"));
+        options_.push_back(new SimpleOption<size_t>("threads", "Number of requests processed concurrently"));
+        options_.push_back(new SimpleOption<size_t>(
+            "parallel-omp-num-threads", "Set number of threads for parallel regions (OMP, and matrix assembly)"));
+    }
+
+    int minimumPositionalArguments() const override { return 1; }
+
+    void usage(const std::string& tool) const override {
+        Log::info() << "\n"
+                       "Create caches (Legendre coefficients, interpolation matrices, ...) by post-processing sample "
+                       "fields, for each distinct input representation and request."
+                       "\n"
+                       "\n"
+                       "Requests run on --threads concurrent threads, but Legendre coefficients are created one at a "
+                       "time (process-wide, spectral transforms are serialised); their creation is only parallel with "
+                       "--parallel-omp-num-threads (OpenMP, inside atlas). To create coefficients for several "
+                       "truncation/grid pairs concurrently, run several processes."
+                       "\n"
+                       "\n"
+                       "Usage: "
+                    << tool
+                    << " [--request='--key=value ...'] [--requests=file] [--threads=N] file.grib [file.grib ...]"
+                       "\n"
+                       "Examples:"
+                       "\n"
+                       "  % "
+                    << tool
+                    << " --request='--grid=O2560' --parallel-omp-num-threads=16 tco2559.grib"
+                       "\n"
+                       "  % "
+                    << tool << " --requests=requests.txt --threads=4 samples.grib" << std::endl;
+    }
+
+    void execute(const eckit::option::CmdArgs& /*args*/) override;
+};
+
+
+void MIRCacheWarm::execute(const eckit::option::CmdArgs& args) {
+    trace::Timer timer("Total time");
+
+    const param::ConfigurationWrapper param(args);
+
+    // requests
+    std::vector<std::string> requests;
+
+    std::string request;
+    if (param.get("request", request) && !request.empty()) {
+        requests.push_back(request);
+    }
+
+    std::string path;
+    if (param.get("requests", path)) {
+        std::ifstream in(path);
+        if (!in) {
+            throw exception::CantOpenFile(path);
+        }
+
+        for (std::string line; std::getline(in, line);) {
+            if (auto first = line.find_first_not_of(" \t"); first != std::string::npos && line[first] != '#') {
+                requests.push_back(line);
+            }
+        }
+    }
+
+    if (requests.empty()) {
+        throw exception::UserError("MIRCacheWarm: no requests, use --request or --requests");
+    }
+
+    // sample fields, one per distinct representation
+    std::vector<std::vector<char>> fields;
+    std::set<std::string> representations;
+
+    for (const std::string& arg : args) {
+        std::unique_ptr<input::MIRInput> input(input::MIRInputFactory::build(arg, param));
+        ASSERT(input);
+
+        while (input->next()) {
+            repres::RepresentationHandle repres(repres::RepresentationFactory::build(input->parametrisation()));
+            if (!representations.insert(repres->uniqueName()).second) {
+                continue;
+            }
+
+            const void* data = nullptr;
+            size_t size      = 0;
+            GRIB_CALL(codes_get_message(input->gribHandle(), &data, &size));
+
+            const auto* begin = static_cast<const char*>(data);
+            fields.emplace_back(begin, begin + size);
+        }
+    }
+
+    // tasks: fields x requests, on concurrent threads (caches create each entry once)
+    const auto tasks = fields.size() * requests.size();
+
+    size_t threads = 1;
+    param.get("threads", threads);
+    threads = std::max<size_t>(1, std::min(threads, tasks));
+
+    size_t ompThreads = 0;
+    param.get("parallel-omp-num-threads", ompThreads);
+
+    Log::info() << "MIRCacheWarm: " << Log::Pretty(fields.size(), {"representation"}) << " x "
+                << Log::Pretty(requests.size(), {"request"}) << ", " << Log::Pretty(threads, {"thread"})
+                << std::endl;
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> failed{0};
+    std::vector<util::MIRStatistics> statistics(threads);
+    util::recursive_mutex mutex;
+
+    auto run = [&](size_t t) {
+        for (size_t task; (task = next++) < tasks;) {
+            const auto& field   = fields[task / requests.size()];
+            const auto& request = requests[task % requests.size()];
+
+            try {
+                api::MIRJob job;
+                job.set(request);
+                if (ompThreads > 0) {
+                    job.set("parallel-omp-num-threads", ompThreads);
+                }
+
+                input::GribMemoryInput input(field.data(), field.size());
+                output::EmptyOutput output;
+
+                job.execute(input, output, statistics[t]);
+            }
+            catch (std::exception& e) {
+                util::lock_guard<util::recursive_mutex> lock(mutex);
+                Log::error() << "MIRCacheWarm: request '" << request << "': " << e.what() << std::endl;
+                ++failed;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back(run, t);
+    }
+
+    run(0);
+
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    util::MIRStatistics total;
+    for (const auto& s : statistics) {
+        total += s;
+    }
+    total.report(Log::info());
+
+    Log::info() << "MIRCacheWarm: " << Log::Pretty(tasks, {"task"}) << " in " << timer.elapsedSeconds() << std::endl;
+
+    if (failed > 0) {
+        throw exception::SeriousBug("MIRCacheWarm: " + std::to_string(failed.load()) + " task(s) failed");
+    }
+}
+
+
+}  // namespace mir::tools
+
+
+int main(int argc, char** argv) {
+    mir::tools::MIRCacheWarm tool(argc, argv);
+    return tool.start();
+}
@@ -322,6 +322,8 @@ void MIRClimateFilter::execute(const eckit::option::CmdArgs& args) {
             << ", rate: " << double(field) / timer.elapsed() << " "
             << "field/s" << std::endl;
     }
+
+    out->flush();
 }
 
 
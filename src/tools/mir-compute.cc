@@ -144,6 +144,8 @@ void MIRCompute::execute(const eckit::option::CmdArgs& args) {
             save->perform(ctx);
         }
     }
+
+    output->flush();
 }
 
 
@@ -75,6 +75,7 @@ struct MIRGridBoxArea : MIRTool {
 
             std::unique_ptr<output::MIROutput> out(output::MIROutputFactory::build(arg + ".area", *param));
             out->save(*param, ctx);
+            out->flush();
         }
     }
 };
@@ -174,6 +174,7 @@ void MIRStatistics::execute(const eckit::option::CmdArgs& args) {
 
             std::unique_ptr<output::MIROutput> out(new output::GribFileOutput(j));
             out->save(*param, ctx);
+            out->flush();
         }
 
         log.precision(old);
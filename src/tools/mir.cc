@@ -10,9 +10,17 @@
  */
 
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <ostream>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "eckit/linalg/LinearAlgebraDense.h"
@@ -27,12 +35,14 @@
 #include "mir/action/filter/NablaFilter.h"
 #include "mir/action/plan/Executor.h"
 #include "mir/api/MIRJob.h"
-#include "mir/api/mir_config.h"
 #include "mir/caching/legendre/LegendreLoader.h"
 #include "mir/caching/matrix/MatrixLoader.h"
 #include "mir/data/Space.h"
 #include "mir/grib/BasicAngle.h"
 #include "mir/grib/Packing.h"
+#include "mir/input/GribInput.h"
+#include "mir/input/GribMemoryInput.h"
+#include "mir/input/MultiDimensionalInput.h"
 #include "mir/input/MIRInput.h"
 #include "mir/key/Area.h"
 #include "mir/key/grid/GridPattern.h"
@@ -47,16 +57,21 @@
 #include "mir/method/knn/distance/DistanceWeightingWithLSM.h"
 #include "mir/method/knn/pick/Pick.h"
 #include "mir/method/nonlinear/NonLinear.h"
+#include "mir/output/BatchOutput.h"
+#include "mir/output/GribBufferOutput.h"
 #include "mir/output/MIROutput.h"
 #include "mir/param/ConfigurationWrapper.h"
+#include "mir/param/MIRParametrisation.h"
 #include "mir/search/Tree.h"
 #include "mir/stats/Distribution.h"
 #include "mir/stats/Field.h"
 #include "mir/stats/Statistics.h"
 #include "mir/tools/MIRTool.h"
 #include "mir/util/Exceptions.h"
+#include "mir/util/Grib.h"
 #include "mir/util/Log.h"
 #include "mir/util/MIRStatistics.h"
+#include "mir/util/Reorder.h"
 #include "mir/util/SpectralOrder.h"
 #include "mir/util/Trace.h"
 #include "mir/util/Types.h"
@@ -180,6 +195,15 @@ struct MIR : MIRTool {
             new SimpleOption<double>("cressman-model-extension-power", "Cressman Model Extension power (default 1.)"));
 
         options_.push_back(new SimpleOption<bool>("caching", "Caching of weights and k-d trees (default 1)"));
+        options_.push_back(new SimpleOption<bool>(
+            "interpolation-batch",
+            "Interpolate all field dimensions with a single matrix multiplication, if possible (default 0)"));
+        options_.push_back(new SimpleOption<bool>(
+            "matrix-single-precision",
+            "Interpolation weights in single precision, for linear interpolation (no missing values, default 0)"));
+        options_.push_back(new FactoryOption<util::Reorder>(
+            "matrix-reorder",
+            "Interpolation matrix rows/columns locality reordering, transparent to results (eg. hilbert, morton)"));
         options_.push_back(new FactoryOption<eckit::linalg::LinearAlgebraDense>(
             "dense-backend",
             "Linear algebra dense backend (default '" + eckit::linalg::LinearAlgebraDense::backend().name() + "')"));
@@ -358,10 +382,13 @@ struct MIR : MIRTool {
         options_.push_back(new FactoryOption<caching::legendre::LegendreLoaderFactory>(
             "legendre-loader", "Select how to load Legendre coefficients in memory"));
 
-        if constexpr (MIR_HAVE_OMP) {
-            options_.push_back(
-                new SimpleOption<size_t>("parallel-omp-num-threads", "Set number of threads for OMP parallel regions"));
-        }
+        options_.push_back(new SimpleOption<size_t>(
+            "parallel-omp-num-threads", "Set number of threads for parallel regions (OMP, and matrix assembly)"));
+        options_.push_back(new SimpleOption<size_t>(
+            "parallel-fields", "Process GRIB fields concurrently on this many threads, writing in input order"));
+        options_.push_back(new SimpleOption<size_t>(
+            "batch-spectral-fields",
+            "Transform up to this many consecutive spectral fields together (same truncation, parameter, level type)"));
 
         //==============================================
         // Only show these options if debug channel is active
@@ -379,6 +406,8 @@ struct MIR : MIRTool {
             options_.push_back(new SimpleOption<std::string>("dump-statistics-file",
                                                              "Write statistics to file (after plan execution)"));
             options_.push_back(new SimpleOption<bool>("dont-compress-plan", "Don't compress plan"));
+            options_.push_back(
+                new SimpleOption<bool>("plan-cache", "Reuse plans for fields of same metadata (default true)"));
             options_.push_back(new FactoryOption<output::MIROutputFactory>("format", "Output format"));
             options_.push_back(
                 new SimpleOption<bool>("reset-missing-values", "Use first encoded value to set missing value"));
@@ -423,6 +452,12 @@ struct MIR : MIRTool {
 
     void only(const api::MIRJob& /*job*/, input::MIRInput& /*input*/, output::MIROutput& /*output*/,
               const std::string& /*what*/, size_t /*paramId*/);
+
+    void parallel(const api::MIRJob& /*job*/, input::MIRInput& /*input*/, output::GribOutput& /*output*/,
+                  const std::string& /*what*/, size_t /*workers*/);
+
+    void batch(const api::MIRJob& /*job*/, input::MIRInput& /*input*/, output::MIROutput& /*output*/,
+               const std::string& /*what*/, size_t /*size*/);
 };
 
 
@@ -465,13 +500,44 @@ void MIR::execute(const eckit::option::CmdArgs& args) {
     std::unique_ptr<input::MIRInput> input(input::MIRInputFactory::build(args(0), args_wrap));
     ASSERT(input);
 
-    size_t onlyParamId = 0;
+    size_t onlyParamId    = 0;
+    size_t parallelFields = 0;
+    size_t batchFields    = 0;
+    auto* gribOutput      = dynamic_cast<output::GribOutput*>(output.get());
+    auto* gribInput       = dynamic_cast<input::GribInput*>(input.get());
+
+    // input options (auxiliary information) are attached to the input, not to fields copied from it
+    std::string inputOptions;
+    const bool auxiliary = args.get("input", inputOptions) && !inputOptions.empty();
+
     if (args.get("only", onlyParamId)) {
         only(job, *input, *output, "field", onlyParamId);
-        return;
+    }
+    else if (args.get("parallel-fields", parallelFields) && parallelFields > 1 && gribInput != nullptr &&
+             gribOutput != nullptr && !auxiliary) {
+        parallel(job, *input, *gribOutput, "field", parallelFields);
+    }
+    else if (args.get("batch-spectral-fields", batchFields) && batchFields > 1 && gribInput != nullptr &&
+             !job.has("uv2uv") && !job.has("vod2uv") && !job.has("filter") && !auxiliary) {
+        batch(job, *input, *output, "field", batchFields);
+    }
+    else {
+        if (parallelFields > 1) {
+            Log::warning() << "MIR: --parallel-fields requires GRIB input and output (and no --input), processing "
+                              "fields serially"
+                           << std::endl;
+        }
+        if (batchFields > 1) {
+            Log::warning() << "MIR: --batch-spectral-fields requires GRIB input and scalar fields (no 'uv2uv', "
+                              "'vod2uv' or 'filter', and no --input), processing fields one by one"
+                           << std::endl;
+        }
+
+        process(job, *input, *output, "field");
     }
 
-    process(job, *input, *output, "field");
+    // write buffered messages, reporting errors
+    output->flush();
 }
 
 
@@ -518,6 +584,229 @@ void MIR::only(const api::MIRJob& job, input::MIRInput& input, output::MIROutput
 }
 
 
+void MIR::parallel(const api::MIRJob& job, input::MIRInput& input, output::GribOutput& output,
+                   const std::string& what, size_t workers) {
+    trace::Timer timer("Total time");
+
+    ASSERT(workers > 0);
+    Log::debug() << "Using " << workers << " threads for processing " << what << "s" << std::endl;
+
+    // reader (this thread) -> workers (decode, plan, encode) -> ordered writer (this thread)
+    using Message = std::pair<size_t, std::vector<char>>;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<Message> queue;                                   // messages to process
+    std::map<size_t, output::GribBufferOutput::Messages> done;  // messages to write, by input order
+    std::exception_ptr error;
+    bool eof = false;
+
+    std::vector<util::MIRStatistics> statistics(workers);
+    std::vector<std::thread> pool;
+
+    for (size_t w = 0; w < workers; ++w) {
+        pool.emplace_back([&, w]() {
+            output::GribBufferOutput buffer;  // per worker, so action plans are reused
+
+            for (;;) {
+                Message message;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond.wait(lock, [&]() { return !queue.empty() || eof || error; });
+                    if (queue.empty() || error) {
+                        return;
+                    }
+
+                    message = std::move(queue.front());
+                    queue.pop_front();
+                }
+
+                try {
+                    input::GribMemoryInput field(message.second.data(), message.second.size());
+                    job.execute(field, buffer, statistics[w]);
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done.emplace(message.first, buffer.release());
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+
+                cond.notify_all();
+            }
+        });
+    }
+
+    // bound the number of fields in memory (read, but not written)
+    const size_t window = 2 * workers;
+    size_t read         = 0;
+    size_t written      = 0;
+
+    try {
+        for (bool more = true; more;) {
+            std::vector<char> message;
+            if ((more = input.next())) {
+                const void* data = nullptr;
+                size_t size      = 0;
+                GRIB_CALL(codes_get_message(input.gribHandle(), &data, &size));
+
+                const auto* begin = static_cast<const char*>(data);
+                message.assign(begin, begin + size);
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            if (more) {
+                Log::debug() << "============> " << what << ": " << (read + 1) << std::endl;
+                queue.emplace_back(read++, std::move(message));
+            }
+            else {
+                eof = true;
+            }
+            cond.notify_all();
+
+            // write in order, until more fields can be read (or all fields are written)
+            for (;;) {
+                cond.wait(lock, [&]() {
+                    return error || done.find(written) != done.end() || written == read ||
+                           (more && read - written < window);
+                });
+
+                auto j = done.find(written);
+                if (error || j == done.end()) {
+                    break;
+                }
+
+                auto messages = std::move(j->second);
+                done.erase(j);
+
+                lock.unlock();
+                output::GribBufferOutput::write(messages, output);
+                lock.lock();
+
+                ++written;
+            }
+
+            if (error) {
+                break;
+            }
+        }
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        eof = true;
+    }
+    cond.notify_all();
+
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    ASSERT(written == read);
+
+    util::MIRStatistics total;
+    for (const auto& s : statistics) {
+        total += s;
+    }
+    total.report(Log::info());
+
+    Log::info() << Log::Pretty(read, what) << " in " << timer.elapsedSeconds()
+                << ", rate: " << double(read) / timer.elapsed() << " " << what << "/s" << std::endl;
+}
+
+
+// Fields that can be batched together (same truncation, parameter, level type and encoding), empty if not spectral
+static std::string batch_key(const param::MIRParametrisation& field) {
+    if (!field.has("spectral")) {
+        return {};
+    }
+
+    std::ostringstream key;
+    for (const auto* name : {"truncation", "paramId", "levtype", "edition", "packing", "accuracy"}) {
+        std::string value;
+        field.get(name, value);
+        key << name << "=" << value << ";";
+    }
+    return key.str();
+}
+
+
+void MIR::batch(const api::MIRJob& job, input::MIRInput& input, output::MIROutput& output, const std::string& what,
+                size_t size) {
+    trace::Timer timer("Total time");
+
+    ASSERT(size > 1);
+    Log::debug() << "Batching up to " << size << " spectral " << what << "s" << std::endl;
+
+    util::MIRStatistics statistics;
+    output::BatchOutput batchOutput(output);  // the same for all batches, so action plans are reused
+
+    // consecutive spectral fields (copies), transformed together as a multi-dimensional field
+    std::vector<std::vector<char>> messages;
+    std::string key;
+
+    auto flush = [&]() {
+        if (messages.size() == 1) {
+            input::GribMemoryInput field(messages.front().data(), messages.front().size());
+            job.execute(field, output, statistics);
+        }
+        else if (messages.size() > 1) {
+            Log::debug() << "============> batch: " << messages.size() << " " << what << "s" << std::endl;
+
+            input::MultiDimensionalInput fields;
+            for (const auto& message : messages) {
+                fields.append(new input::GribMemoryInput(message.data(), message.size()));
+            }
+            job.execute(fields, batchOutput, statistics);
+        }
+        messages.clear();
+    };
+
+    size_t i = 0;
+    while (input.next()) {
+        Log::debug() << "============> " << what << ": " << (++i) << std::endl;
+
+        auto k = batch_key(input.parametrisation());
+        if (k.empty() || k != key || messages.size() == size) {
+            flush();
+            key = k;
+        }
+
+        if (k.empty()) {
+            job.execute(input, output, statistics);
+            continue;
+        }
+
+        const void* data = nullptr;
+        size_t length    = 0;
+        GRIB_CALL(codes_get_message(input.gribHandle(), &data, &length));
+
+        const auto* begin = static_cast<const char*>(data);
+        messages.emplace_back(begin, begin + length);
+    }
+
+    flush();
+
+    statistics.report(Log::info());
+
+    Log::info() << Log::Pretty(i, what) << " in " << timer.elapsedSeconds() << ", rate: " << double(i) / timer.elapsed()
+                << " " << what << "/s" << std::endl;
+}
+
+
 }  // namespace tools
 }  // namespace mir
 
@@ -0,0 +1,110 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <utime.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/testing/Test.h"
+
+#include "mir/caching/CacheManagerFileLease.h"
+
+
+namespace mir::tests::unit {
+
+
+CASE("CacheManagerFileLease: stale lease takeover") {
+    const eckit::PathName path("cache_lease.test");
+    const eckit::PathName lease(path + ".lease");
+    path.unlink(false);
+
+    // stale lease, left by a process on another host
+    {
+        std::ofstream out(lease.localPath());
+        out << "another-host 1" << std::endl;
+    }
+
+    struct utimbuf times {};
+    times.actime = times.modtime = std::time(nullptr) - 60;
+    EXPECT(::utime(lease.localPath(), &times) == 0);
+
+    // waiters take over the stale lease concurrently, the entry is created only once and by one lease holder at a time
+    constexpr size_t N = 4;
+
+    std::atomic<int> holders{0};
+    std::atomic<int> overlaps{0};
+    std::atomic<int> creators{0};
+
+    std::vector<std::exception_ptr> errors(N);
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < N; ++i) {
+        threads.emplace_back([&, i]() {
+            try {
+                caching::CacheManagerFileLease l(path);
+                l.lock();
+
+                if (holders++ > 0) {
+                    overlaps++;
+                }
+
+                if (!path.exists()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                    std::ofstream(path.localPath()) << "entry" << std::endl;
+                    creators++;
+                }
+
+                holders--;
+                l.unlock();
+            }
+            catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (const auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+
+    EXPECT(overlaps == 0);
+    EXPECT(creators == 1);
+    EXPECT(!lease.exists());
+    EXPECT(!eckit::PathName(lease + ".takeover").exists());
+
+    path.unlink();
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    // short staleness (seconds), so the test runs quickly (read on first use)
+    ::setenv("MIR_CACHE_LEASE_STALE", "2", 1);
+
+    return eckit::testing::run_tests(argc, argv);
+}
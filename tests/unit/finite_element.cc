@@ -0,0 +1,102 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <algorithm>
+#include <string>
+
+#include "eckit/testing/Test.h"
+
+#include "mir/key/grid/Grid.h"
+#include "mir/method/WeightMatrix.h"
+#include "mir/method/fe/FiniteElement.h"
+#include "mir/param/SimpleParametrisation.h"
+#include "mir/repres/Representation.h"
+#include "mir/util/Log.h"
+#include "mir/util/MIRStatistics.h"
+
+
+namespace mir::tests::unit {
+
+
+// finite element (bilinear), exposing the matrix assembly and projection statistics
+struct FiniteElementAssemble final : method::fe::FiniteElement {
+    explicit FiniteElementAssemble(const param::MIRParametrisation& param) : FiniteElement(param) {
+        meshGeneratorParams().set("triangulate", false).set("angle", 0.);
+    }
+
+    void assemble(method::WeightMatrix& W, const repres::Representation& in, const repres::Representation& out,
+                  ProjectionStatistics& stats) const {
+        util::MIRStatistics statistics;
+        FiniteElement::assemble(statistics, W, in, out, stats);
+    }
+
+private:
+    const char* type() const override { return "finite-element-assemble"; }
+};
+
+
+CASE("finite element: threaded assembly") {
+    auto& log = Log::info();
+
+    const repres::RepresentationHandle in(key::grid::Grid::lookup("O16").representation());
+
+    for (const std::string grid : {"O24", "F16"}) {
+        log << "Test O16 to " << grid << std::endl;
+
+        const repres::RepresentationHandle out(key::grid::Grid::lookup(grid).representation());
+
+        auto assemble = [&](size_t threads, method::WeightMatrix& W,
+                            FiniteElementAssemble::ProjectionStatistics& stats) {
+            param::SimpleParametrisation param;
+            param.set("caching", false);
+            param.set("finite-element-projection-fail", "failure");  // record failures
+            param.set("parallel-omp-num-threads", threads);
+
+            FiniteElementAssemble(param).assemble(W, *in, *out, stats);
+        };
+
+        method::WeightMatrix serial(out->numberOfPoints(), in->numberOfPoints());
+        FiniteElementAssemble::ProjectionStatistics serialStats;
+        assemble(1, serial, serialStats);
+
+        EXPECT(serial.nonZeros() > 0);
+        EXPECT(serialStats.nbProjections + serialStats.failures.size() == out->numberOfPoints());
+
+        for (size_t threads : {2, 4}) {
+            method::WeightMatrix threaded(out->numberOfPoints(), in->numberOfPoints());
+            FiniteElementAssemble::ProjectionStatistics stats;
+            assemble(threads, threaded, stats);
+
+            // same matrix, entry by entry
+            EXPECT(threaded.rows() == serial.rows());
+            EXPECT(threaded.nonZeros() == serial.nonZeros());
+            EXPECT(std::equal(serial.outer(), serial.outer() + serial.rows() + 1, threaded.outer()));
+            EXPECT(std::equal(serial.inner(), serial.inner() + serial.nonZeros(), threaded.inner()));
+            EXPECT(std::equal(serial.data(), serial.data() + serial.nonZeros(), threaded.data()));
+
+            // same statistics, failures in the same order
+            EXPECT(stats.nbProjections == serialStats.nbProjections);
+            EXPECT(stats.nbMinElementsSearched == serialStats.nbMinElementsSearched);
+            EXPECT(stats.nbMaxElementsSearched == serialStats.nbMaxElementsSearched);
+            EXPECT(stats.nbMaxProjectionAttempts == serialStats.nbMaxProjectionAttempts);
+            EXPECT(stats.failures == serialStats.failures);
+        }
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -10,17 +10,22 @@
  */
 
 
+#include <exception>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "eckit/testing/Test.h"
 
 #include "mir/action/area/AreaCropper.h"
+#include "mir/api/MIRJob.h"
 #include "mir/api/mir_config.h"
 #include "mir/data/MIRField.h"
+#include "mir/input/GribFileInput.h"
 #include "mir/input/GribMemoryInput.h"
 #include "mir/key/grid/Grid.h"
+#include "mir/output/GribBufferOutput.h"
 #include "mir/repres/Iterator.h"
 #include "mir/repres/Representation.h"
 #include "mir/repres/latlon/RegularLL.h"
@@ -621,6 +626,65 @@ CASE("GRIB1/GRIB2 deleteLocalDefinition") {
 }
 
 
+CASE("GRIB encoding, concurrent") {
+    const std::vector<std::string> packings{"simple", "second-order", "ieee"};
+
+    auto encode = [](const std::string& packing) {
+        input::GribFileInput input("gridName=N320.area=5_75_-50_180.grib2");
+        ASSERT(input.next());
+
+        api::MIRJob job;
+        job.set("grid", std::vector<double>{1., 1.});
+        job.set("packing", packing);
+        job.set("caching", false);
+
+        output::GribBufferOutput output;
+        job.execute(input, output);
+
+        auto messages = output.release();
+        ASSERT(messages.size() == 1);
+        return messages.front().data;
+    };
+
+    // serial encoding
+    std::vector<std::vector<char>> reference;
+    for (const auto& packing : packings) {
+        reference.emplace_back(encode(packing));
+    }
+
+    // concurrent encoding (same bytes)
+    constexpr size_t N = 12;
+    std::vector<std::vector<char>> result(N);
+    std::vector<std::exception_ptr> errors(N);
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < N; ++i) {
+        threads.emplace_back([&, i]() {
+            try {
+                result[i] = encode(packings[i % packings.size()]);
+            }
+            catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT(result[i] == reference[i % packings.size()]);
+    }
+}
+
+
 }  // namespace mir::tests::unit
 
 int main(int argc, char** argv) {
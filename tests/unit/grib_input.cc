@@ -15,8 +15,11 @@
 
 #include "eckit/testing/Test.h"
 
+#include "mir/input/GribFileIndex.h"
 #include "mir/input/GribFileInput.h"
+#include "mir/input/GribMappedFileInput.h"
 #include "mir/util/Exceptions.h"
+#include "mir/util/Grib.h"
 #include "mir/util/Log.h"
 
 
@@ -104,6 +107,98 @@ CASE("GribFileInput") {
 }
 
 
+CASE("GribFileIndex") {
+    const std::string path = "../data/date=20200308,level=1000,grid=O80,param=u_v";
+
+    input::GribFileIndex index(path);
+    EXPECT(index.entries().size() == 2);
+    EXPECT(index.indexed("paramId"));
+    EXPECT(index.find(0, "paramId", "132") == 1);
+    EXPECT(index.find(2, "paramId", "132") == 2);
+
+
+    SECTION("GribFileInput::only") {
+        for (long paramId : {131L, 132L}) {
+            std::unique_ptr<input::MIRInput> input(new input::GribFileInput(path));
+
+            EXPECT(input->only(static_cast<size_t>(paramId)));
+
+            long value = 0;
+            EXPECT(input->parametrisation().get("paramId", value));
+            EXPECT_EQUAL(value, paramId);
+
+            EXPECT(!input->only(static_cast<size_t>(paramId)));
+        }
+    }
+
+
+    SECTION("headers only") {
+        // index values (from the message headers) are the same as from the complete messages
+        for (const auto* file : {
+                 "../data/date=20200308,level=1000,grid=O80,param=u_v",
+                 "../data/param=vo_d,level=1000,resol=20",
+                 "../data/ICON.shortName=lsm.grib2",
+                 "../data/MIR-375.grib1",
+             }) {
+            input::GribFileIndex index(file);
+            EXPECT(!index.entries().empty());
+
+            for (const auto& entry : index.entries()) {
+                input::GribFileInput input(file, entry.offset);
+                EXPECT(input.next());
+
+                auto* h = input.gribHandle();
+                ASSERT(h != nullptr);
+
+                size_t length = 0;
+                EXPECT(codes_get_message_size(h, &length) == CODES_SUCCESS);
+                EXPECT_EQUAL(length, entry.length);
+
+                for (size_t i = 0; i < index.keys().size(); ++i) {
+                    char value[1024];
+                    size_t len = sizeof(value);
+                    const std::string expected =
+                        codes_get_string(h, index.keys()[i].c_str(), value, &len) == CODES_SUCCESS ? value : "";
+                    EXPECT_EQUAL(entry.values[i], expected);
+                }
+            }
+        }
+    }
+}
+
+
+CASE("GribMappedFileInput") {
+    for (const auto* path : {
+             "../data/date=20200308,level=1000,grid=O80,param=u_v",
+             "../data/param=vo_d,level=1000,resol=20",
+         }) {
+        Log::info() << "Testing '" << path << "'..." << std::endl;
+
+        input::GribFileInput stream(path);
+        input::GribMappedFileInput mapped(path);
+
+        // same messages, in the same order
+        size_t count = 0;
+        for (bool more = true; more; ++count) {
+            more = stream.next();
+            EXPECT(more == mapped.next());
+
+            if (more) {
+                long a = 0;
+                long b = 0;
+                EXPECT(stream.parametrisation().get("paramId", a));
+                EXPECT(mapped.parametrisation().get("paramId", b));
+                EXPECT_EQUAL(a, b);
+
+                EXPECT(stream.field().values(0) == mapped.field().values(0));
+            }
+        }
+
+        EXPECT(count == 3);
+    }
+}
+
+
 }  // namespace mir::tests::unit
 
 
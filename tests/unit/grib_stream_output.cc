@@ -0,0 +1,72 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <cstdlib>
+#include <ostream>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/DataHandle.h"
+#include "eckit/testing/Test.h"
+
+#include "mir/api/MIRJob.h"
+#include "mir/input/GribFileInput.h"
+#include "mir/output/GribStreamOutput.h"
+
+
+namespace mir::tests::unit {
+
+
+struct FailingHandle : eckit::DataHandle {
+    void print(std::ostream& out) const override { out << "FailingHandle"; }
+    long write(const void* /*buffer*/, long /*length*/) override { throw eckit::WriteError("FailingHandle"); }
+};
+
+
+class FailingOutput : public output::GribStreamOutput {
+    FailingHandle handle_;
+
+    eckit::DataHandle& dataHandle() override { return handle_; }
+    bool sameAs(const MIROutput& other) const override { return this == &other; }
+    void print(std::ostream& out) const override { out << "FailingOutput"; }
+
+public:
+    ~FailingOutput() override { close(); }
+};
+
+
+CASE("GribStreamOutput: writing errors") {
+    input::GribFileInput input("gridName=N320.area=5_75_-50_180.grib2");
+    ASSERT(input.next());
+
+    api::MIRJob job;
+    job.set("grid", std::vector<double>{1., 1.});
+    job.set("caching", false);
+
+    // messages are written behind (see main), so the error is reported on flush (or on a later write)
+    FailingOutput output;
+    EXPECT_THROWS({
+        job.execute(input, output);
+        output.flush();
+    });
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    // write behind, in blocks larger than the messages (read on first use)
+    ::setenv("MIR_GRIB_OUTPUT_BUFFER_SIZE", "1048576", 1);
+
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -10,14 +10,23 @@
  */
 
 
+#include <memory>
+#include <numeric>
 #include <string>
 #include <vector>
 
 #include "eckit/testing/Test.h"
 
+#include "mir/action/plan/Job.h"
+#include "mir/action/plan/PlanCache.h"
 #include "mir/api/MIRJob.h"
+#include "mir/input/RawInput.h"
 #include "mir/key/grid/Grid.h"
+#include "mir/output/ArrayOutput.h"
+#include "mir/param/GridSpecParametrisation.h"
+#include "mir/param/RuntimeParametrisation.h"
 #include "mir/repres/Representation.h"
+#include "mir/util/MIRStatistics.h"
 
 // define EXPECTV(a) log << "\tEXPECT(" << #a <<")" << std::endl; EXPECT(a)
 
@@ -44,6 +53,92 @@ CASE("Representation::fillJob(MIRJob&)") {
 }
 
 
+CASE("MIRJob plan cache") {
+    // input metadata differing in relevant (grid) and irrelevant (paramId) ways
+    param::GridSpecParametrisation grid2("{grid: [2, 2], area: [20, 1, 1, 20]}");
+    param::GridSpecParametrisation grid1("{grid: [1, 1], area: [20, 1, 1, 20]}");
+
+    param::RuntimeParametrisation a(grid2);
+    param::RuntimeParametrisation b(grid2);
+    param::RuntimeParametrisation c(grid1);
+    a.set("paramId", 130L);
+    b.set("paramId", 131L);
+    c.set("paramId", 130L);
+
+    auto interpolate = [](api::MIRJob& job, const param::MIRParametrisation& meta, size_t N) {
+        std::vector<double> values(N);
+        std::iota(values.begin(), values.end(), 0.);
+
+        std::unique_ptr<input::MIRInput> input(new input::RawInput(values.data(), values.size(), meta));
+        output::ArrayOutput output;
+
+        job.execute(*input, output);
+        return output.values();
+    };
+
+    api::MIRJob cached;
+    cached.set("grid", std::vector<double>{4., 4.});
+    cached.set("caching", false);
+
+    api::MIRJob uncached;
+    uncached.set("grid", std::vector<double>{4., 4.});
+    uncached.set("caching", false);
+    uncached.set("plan-cache", false);
+
+    // same results, with or without plan cache
+    for (size_t i = 0; i < 2; ++i) {
+        EXPECT(interpolate(cached, a, 100) == interpolate(uncached, a, 100));
+        EXPECT(interpolate(cached, b, 100) == interpolate(uncached, b, 100));
+        EXPECT(interpolate(cached, c, 400) == interpolate(uncached, c, 400));
+    }
+}
+
+
+CASE("PlanCache reuse") {
+    param::GridSpecParametrisation grid2("{grid: [2, 2], area: [20, 1, 1, 20]}");
+    param::GridSpecParametrisation grid1("{grid: [1, 1], area: [20, 1, 1, 20]}");
+
+    api::MIRJob job;
+    job.set("grid", std::vector<double>{4., 4.});
+    job.set("caching", false);
+
+    action::PlanCache cache;
+    util::MIRStatistics statistics;
+
+    auto interpolate = [&](const param::MIRParametrisation& meta, size_t N, output::ArrayOutput& output) {
+        std::vector<double> values(N);
+        std::iota(values.begin(), values.end(), 0.);
+
+        input::RawInput input(values.data(), values.size(), meta);
+        action::Job(job, input, output, true, cache).execute(statistics);
+        return output.values();
+    };
+
+    output::ArrayOutput output;
+    const auto reference = interpolate(grid2, 100, output);
+    EXPECT(cache.hits() == 0);
+
+    // same job, output and field metadata
+    EXPECT(interpolate(grid2, 100, output) == reference);
+    EXPECT(cache.hits() == 1);
+
+    // different field metadata
+    interpolate(grid1, 400, output);
+    EXPECT(cache.hits() == 1);
+
+    EXPECT(interpolate(grid2, 100, output) == reference);
+    EXPECT(cache.hits() == 2);
+
+    // plans reference their output, so are not reused with other outputs (possibly at the same address)
+    for (size_t i = 0; i < 2; ++i) {
+        output::ArrayOutput other;
+        EXPECT(other.id() != output.id());
+        EXPECT(interpolate(grid2, 100, other) == reference);
+        EXPECT(cache.hits() == 2);
+    }
+}
+
+
 }  // namespace mir::tests::unit
 
 
@@ -10,15 +10,22 @@
  */
 
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "eckit/testing/Test.h"
 
+#include "mir/key/grid/Grid.h"
+#include "mir/method/WeightMatrix.h"
+#include "mir/method/knn/KNearestNeighbours.h"
 #include "mir/method/knn/distance/DistanceWeighting.h"
+#include "mir/method/knn/pick/Pick.h"
 #include "mir/param/SimpleParametrisation.h"
+#include "mir/repres/Representation.h"
 #include "mir/util/Log.h"
+#include "mir/util/MIRStatistics.h"
 
 // define EXPECTV(a) log << "\tEXPECT(" << #a <<")" << std::endl; EXPECT(a)
 
@@ -76,6 +83,69 @@ CASE("distance-weighting") {
 }
 
 
+
+// k-nearest neighbours with a given pick, exposing the matrix assembly
+struct KNearestAssemble final : method::knn::KNearestNeighbours {
+    KNearestAssemble(const param::MIRParametrisation& param, const std::string& pick) :
+        KNearestNeighbours(param),
+        pick_(method::knn::pick::PickFactory::build(pick, param)),
+        distanceWeighting_(method::knn::distance::DistanceWeightingFactory::build("inverse-distance-weighting-squared",
+                                                                                 param)) {}
+
+    void assemble(method::WeightMatrix& W, const repres::Representation& in, const repres::Representation& out) const {
+        util::MIRStatistics stats;
+        KNearestNeighbours::assemble(stats, W, in, out, *pick_, *distanceWeighting_);
+    }
+
+private:
+    const char* type() const override { return "k-nearest-assemble"; }
+    bool sameAs(const method::Method&) const override { return false; }
+    const method::knn::pick::Pick& pick() const override { return *pick_; }
+    const method::knn::distance::DistanceWeighting& distanceWeighting() const override { return *distanceWeighting_; }
+
+    std::unique_ptr<const method::knn::pick::Pick> pick_;
+    std::unique_ptr<const method::knn::distance::DistanceWeighting> distanceWeighting_;
+};
+
+
+CASE("k-nearest neighbours: threaded assembly") {
+    auto& log = Log::info();
+
+    const repres::RepresentationHandle in(key::grid::Grid::lookup("O16").representation());
+    const repres::RepresentationHandle out(key::grid::Grid::lookup("O24").representation());
+
+    for (const std::string pick : {"nclosest", "nclosest-or-nearest", "distance-or-nclosest",
+                                   "longest-element-diagonal-and-nclosest"}) {
+        log << "Test " << pick << std::endl;
+
+        auto assemble = [&](size_t threads) {
+            param::SimpleParametrisation param;
+            param.set("caching", false);
+            param.set("nclosest", 4);
+            param.set("parallel-omp-num-threads", threads);
+
+            method::WeightMatrix W(out->numberOfPoints(), in->numberOfPoints());
+            KNearestAssemble(param, pick).assemble(W, *in, *out);
+            return W;
+        };
+
+        const auto serial = assemble(1);
+        EXPECT(serial.nonZeros() > 0);
+
+        for (size_t threads : {2, 4}) {
+            const auto threaded = assemble(threads);
+
+            // same matrix, entry by entry
+            EXPECT(threaded.rows() == serial.rows());
+            EXPECT(threaded.nonZeros() == serial.nonZeros());
+            EXPECT(std::equal(serial.outer(), serial.outer() + serial.rows() + 1, threaded.outer()));
+            EXPECT(std::equal(serial.inner(), serial.inner() + serial.nonZeros(), threaded.inner()));
+            EXPECT(std::equal(serial.data(), serial.data() + serial.nonZeros(), threaded.data()));
+        }
+    }
+}
+
+
 }  // namespace mir::tests::unit
 
 
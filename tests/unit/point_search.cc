@@ -0,0 +1,295 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/testing/Test.h"
+#include "eckit/types/FloatCompare.h"
+
+#include "mir/key/grid/Grid.h"
+#include "mir/param/SimpleParametrisation.h"
+#include "mir/repres/Iterator.h"
+#include "mir/repres/Representation.h"
+#include "mir/repres/latlon/RegularLL.h"
+#include "mir/search/PointSearch.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Increments.h"
+
+
+namespace mir::tests::unit {
+
+
+CASE("PointSearch batch queries") {
+    using search::PointSearch;
+
+    param::SimpleParametrisation param;
+    param.set("caching", false);
+
+    const repres::RepresentationHandle in(key::grid::Grid::lookup("O16").representation());
+    const repres::RepresentationHandle out(key::grid::Grid::lookup("O8").representation());
+
+    const PointSearch tree(param, *in);
+
+    std::vector<PointSearch::PointType> points;
+    for (const std::unique_ptr<repres::Iterator> it(out->iterator()); it->next();) {
+        points.emplace_back(it->point3D());
+    }
+
+    const auto N = points.size();
+    std::vector<PointSearch::PointValueType> closest;
+
+
+    SECTION("closestNPoints") {
+        for (size_t n : {1, 4}) {
+            std::vector<PointSearch::ValueType> indices(N * n);
+            std::vector<double> distances(N * n);
+            tree.closestNPoints(points.data(), N, n, indices.data(), distances.data());
+
+            for (size_t i = 0; i < N; ++i) {
+                tree.closestNPoints(points[i], n, closest);
+                EXPECT(closest.size() == n);
+
+                for (size_t j = 0; j < n; ++j) {
+                    EXPECT(closest[j].payload() == indices[i * n + j]);
+                    EXPECT(eckit::types::is_approximately_equal(Point3::distance(points[i], closest[j].point()),
+                                                                distances[i * n + j], 1e-12));
+                }
+            }
+
+            std::vector<PointSearch::PointValueType> batch;
+            tree.closestNPoints(points.data(), N, n, batch);
+            EXPECT(batch.size() == N * n);
+
+            for (size_t k = 0; k < N * n; ++k) {
+                EXPECT(batch[k].payload() == indices[k]);
+            }
+        }
+    }
+
+
+    SECTION("closestWithinRadius") {
+        const double radius = 0.1;  // unit sphere
+
+        std::vector<size_t> offsets;
+        std::vector<PointSearch::ValueType> indices;
+        std::vector<double> distances;
+        tree.closestWithinRadius(points.data(), N, radius, offsets, indices, distances);
+
+        EXPECT(offsets.size() == N + 1);
+        EXPECT(offsets.back() == indices.size());
+        EXPECT(indices.size() == distances.size());
+
+        for (size_t i = 0; i < N; ++i) {
+            tree.closestWithinRadius(points[i], radius, closest);
+            EXPECT(closest.size() == offsets[i + 1] - offsets[i]);
+
+            for (size_t j = 0; j < closest.size(); ++j) {
+                EXPECT(closest[j].payload() == indices[offsets[i] + j]);
+                EXPECT(distances[offsets[i] + j] <= radius);
+            }
+        }
+
+        std::vector<size_t> batchOffsets;
+        std::vector<PointSearch::PointValueType> batch;
+        tree.closestWithinRadius(points.data(), N, radius, batchOffsets, batch);
+
+        EXPECT(batchOffsets == offsets);
+        EXPECT(batch.size() == indices.size());
+        for (size_t k = 0; k < batch.size(); ++k) {
+            EXPECT(batch[k].payload() == indices[k]);
+        }
+    }
+}
+
+
+CASE("PointSearch structured grids") {
+    using search::PointSearch;
+
+    param::SimpleParametrisation memory;
+    memory.set("point-search-trees", "memory");
+
+    param::SimpleParametrisation structured;
+    structured.set("point-search-trees", "structured");
+
+    auto points3D = [](const repres::Representation& repres) {
+        std::vector<PointSearch::PointType> points;
+        for (const std::unique_ptr<repres::Iterator> it(repres.iterator()); it->next();) {
+            points.emplace_back(it->point3D());
+        }
+        return points;
+    };
+
+    const repres::RepresentationHandle out(key::grid::Grid::lookup("O8").representation());
+    const auto off = points3D(*out);
+
+    // global latitude rings (HEALPix in ring ordering, the regular lat/lon grid has pole rings)
+    for (const std::string grid : {"F16", "N16", "O16", "H4", "2/2"}) {
+        const repres::RepresentationHandle in(grid == "2/2" ? new repres::latlon::RegularLL(util::Increments(2., 2.))
+                                                            : key::grid::Grid::lookup(grid).representation());
+        const PointSearch a(memory, *in);
+        const PointSearch b(structured, *in);
+
+        // structured search (not the k-d tree fallback)
+        std::ostringstream str;
+        str << b;
+        EXPECT(str.str().find("rings=") != std::string::npos);
+
+        // off-grid and on-grid queries
+        for (const auto& points : {off, points3D(*in)}) {
+            const auto N = points.size();
+
+            for (size_t n : {1, 4, 9}) {
+                std::vector<PointSearch::ValueType> ia(N * n);
+                std::vector<PointSearch::ValueType> ib(N * n);
+                std::vector<double> da(N * n);
+                std::vector<double> db(N * n);
+
+                a.closestNPoints(points.data(), N, n, ia.data(), da.data());
+                b.closestNPoints(points.data(), N, n, ib.data(), db.data());
+
+                // same distances (indices can differ for equidistant points), not NaN for on-grid queries
+                for (size_t i = 0; i < N * n; ++i) {
+                    EXPECT(eckit::types::is_approximately_equal(da[i], db[i], 1e-12));
+                }
+            }
+
+            const double radius = 0.2;  // unit sphere
+            std::vector<PointSearch::PointValueType> ca;
+            std::vector<PointSearch::PointValueType> cb;
+
+            for (const auto& p : points) {
+                a.closestWithinRadius(p, radius, ca);
+                b.closestWithinRadius(p, radius, cb);
+                EXPECT(ca.size() == cb.size());
+            }
+        }
+    }
+}
+
+
+// shared memory trees are built in a temporary directory (see main)
+static eckit::PathName sharedMemoryPath;
+
+
+// files under a directory (recursive)
+static std::vector<eckit::PathName> files(const eckit::PathName& dir) {
+    std::vector<eckit::PathName> files;
+    std::vector<eckit::PathName> dirs;
+    dir.children(files, dirs);
+    return files;
+}
+
+
+CASE("PointSearch shared memory") {
+    using search::PointSearch;
+
+    param::SimpleParametrisation memory;
+    memory.set("point-search-trees", "memory");
+
+    param::SimpleParametrisation shared;
+    shared.set("point-search-trees", "shared-memory");
+
+    const repres::RepresentationHandle in(key::grid::Grid::lookup("O16").representation());
+    const repres::RepresentationHandle out(key::grid::Grid::lookup("O8").representation());
+
+    std::vector<PointSearch::PointType> points;
+    for (const std::unique_ptr<repres::Iterator> it(out->iterator()); it->next();) {
+        points.emplace_back(it->point3D());
+    }
+
+    const auto N   = points.size();
+    const size_t n = 4;
+
+    const PointSearch a(memory, *in);
+    std::vector<PointSearch::ValueType> ia(N * n);
+    std::vector<double> da(N * n);
+    a.closestNPoints(points.data(), N, n, ia.data(), da.data());
+
+    // tree file (and its lock), as committed by a builder
+    auto tree = [&]() {
+        std::vector<eckit::PathName> trees;
+        for (const auto& file : files(sharedMemoryPath)) {
+            const auto name = file.baseName().asString();
+            EXPECT(name == in->uniqueName() + ".kdtree" || name == in->uniqueName() + ".kdtree.lock");
+            if (name == in->uniqueName() + ".kdtree") {
+                trees.push_back(file);
+            }
+        }
+        EXPECT(trees.size() == 1);
+
+        struct stat st {};
+        EXPECT(::stat(trees.front().localPath(), &st) == 0);
+        return st.st_ino;
+    };
+
+    EXPECT(files(sharedMemoryPath).empty());
+
+    // build the tree, then map it (not rebuilt)
+    ino_t built = 0;
+    for (size_t pass = 0; pass < 2; ++pass) {
+        const PointSearch b(shared, *in);
+        std::vector<PointSearch::ValueType> ib(N * n);
+        std::vector<double> db(N * n);
+        b.closestNPoints(points.data(), N, n, ib.data(), db.data());
+
+        for (size_t i = 0; i < N * n; ++i) {
+            EXPECT(ia[i] == ib[i]);
+            EXPECT(da[i] == db[i]);
+        }
+
+        if (pass == 0) {
+            built = tree();
+        }
+        else {
+            EXPECT(tree() == built);
+        }
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    using mir::tests::unit::sharedMemoryPath;
+
+    // shared memory trees in a temporary directory (read on first use), removed at the end
+    char dir[] = "/tmp/mir-point-search.XXXXXX";
+    ASSERT(::mkdtemp(dir) != nullptr);
+    ::setenv("MIR_POINT_SEARCH_SHARED_MEMORY_PATH", dir, 1);
+    sharedMemoryPath = dir;
+
+    auto result = eckit::testing::run_tests(argc, argv);
+
+    std::vector<eckit::PathName> files;
+    std::vector<eckit::PathName> dirs;
+    sharedMemoryPath.children(files, dirs);
+
+    for (const auto& file : files) {
+        file.unlink();
+    }
+    for (auto d = dirs.rbegin(); d != dirs.rend(); ++d) {
+        d->rmdir();
+    }
+    sharedMemoryPath.rmdir();
+
+    return result;
+}
@@ -0,0 +1,130 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "eckit/testing/Test.h"
+#include "eckit/types/FloatCompare.h"
+
+#include "mir/api/MIRJob.h"
+#include "mir/input/RawInput.h"
+#include "mir/key/grid/Grid.h"
+#include "mir/output/ArrayOutput.h"
+#include "mir/param/GridSpecParametrisation.h"
+#include "mir/param/RuntimeParametrisation.h"
+#include "mir/repres/Representation.h"
+#include "mir/util/Exceptions.h"
+#include "mir/util/Reorder.h"
+
+
+namespace mir::tests::unit {
+
+
+using util::Reorder;
+
+
+CASE("Reorder") {
+    const repres::RepresentationHandle rep(key::grid::Grid::lookup("O16").representation());
+    const auto N = rep->numberOfPoints();
+
+    std::vector<size_t> identity(N);
+    std::iota(identity.begin(), identity.end(), 0);
+
+
+    SECTION("identity") {
+        std::unique_ptr<Reorder> reorder(Reorder::build("identity", N));
+        EXPECT(reorder->reorder() == identity);
+        EXPECT(reorder->reorder(*rep) == identity);
+    }
+
+
+    SECTION("space-filling curves") {
+        for (const std::string name : {"hilbert", "morton"}) {
+            std::unique_ptr<Reorder> reorder(Reorder::build(name, N));
+            EXPECT_THROWS_AS(reorder->reorder(), exception::UserError);
+
+            // a permutation
+            auto order = reorder->reorder(*rep);
+            EXPECT(order.size() == N);
+            EXPECT(order != identity);
+
+            std::vector<bool> seen(N, false);
+            for (auto i : order) {
+                EXPECT(i < N && !seen[i]);
+                seen[i] = true;
+            }
+        }
+    }
+}
+
+
+CASE("Reorder interpolation matrix") {
+    // input metadata & data
+    param::GridSpecParametrisation in_grid("{grid: [2, 2], area: [20, 1, 1, 20]}");
+    param::RuntimeParametrisation meta(in_grid);
+
+    const double missingValue = 42.;
+    std::vector<double> values(100);
+    std::iota(values.begin(), values.end(), 0.);
+
+    auto interpolate = [&values, &meta](const std::string& reorder) {
+        std::unique_ptr<input::MIRInput> input(new input::RawInput(values.data(), values.size(), meta));
+        output::ArrayOutput output;
+
+        api::MIRJob job;
+        job.set("grid", std::vector<double>{1., 1.});
+        job.set("caching", false);
+        if (!reorder.empty()) {
+            job.set("matrix-reorder", reorder);
+        }
+
+        job.execute(*input, output);
+        return output.values();
+    };
+
+    // same results, up to summation order
+    auto same = [](const std::vector<double>& a, const std::vector<double>& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](double x, double y) {
+                   return eckit::types::is_approximately_equal(x, y, 1e-9);
+               });
+    };
+
+
+    SECTION("without missing values") {
+        const auto reference = interpolate("");
+        EXPECT(same(interpolate("hilbert"), reference));
+        EXPECT(same(interpolate("morton"), reference));
+    }
+
+
+    SECTION("with missing values") {
+        meta.set("missing_value", missingValue);
+        values[3]  = missingValue;
+        values[42] = missingValue;
+
+        const auto reference = interpolate("");
+        EXPECT(same(interpolate("hilbert"), reference));
+        EXPECT(same(interpolate("morton"), reference));
+    }
+}
+
+
+}  // namespace mir::tests::unit
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -10,9 +10,24 @@
  */
 
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/linalg/Matrix.h"
 #include "eckit/testing/Test.h"
+#include "eckit/types/FloatCompare.h"
 
+#include "mir/caching/matrix/MappedMemoryLoader.h"
 #include "mir/method/WeightMatrix.h"
+#include "mir/method/WeightMatrixBuilder.h"
+#include "mir/method/WeightMatrixSinglePrecision.h"
+#include "mir/method/WeightMatrixStructure.h"
+#include "mir/method/nonlinear/NonLinear.h"
+#include "mir/param/SimpleParametrisation.h"
 #include "mir/util/Exceptions.h"
 
 
@@ -99,6 +114,326 @@ CASE("WeightMatrix::validate") {
 }
 
 
+CASE("WeightMatrixBuilder") {
+    const std::vector<method::WeightMatrix::Triplet> triplets{
+        {1, 0, 0.25}, {1, 2, 0.75}, {3, 1, 0.1}, {3, 2, 0.9}, {5, 0, 1.}};
+
+    method::WeightMatrix R(6, 3);
+    R.setFromTriplets(triplets);
+
+    auto compare = [&R](const method::WeightMatrix& W) {
+        EXPECT(W.rows() == R.rows());
+        EXPECT(W.cols() == R.cols());
+        EXPECT(W.nonZeros() == R.nonZeros());
+
+        for (method::WeightMatrix::Size r = 0; r < R.rows(); ++r) {
+            auto i = W.begin(r);
+            for (auto j = R.begin(r); j != R.end(r); ++i, ++j) {
+                EXPECT(i != W.end(r));
+                EXPECT(i.col() == j.col());
+                EXPECT(*i == *j);
+            }
+            EXPECT(i == W.end(r));
+        }
+    };
+
+    SECTION("row by row") {
+        method::WeightMatrixBuilder builder(6, 3);
+        builder.add(triplets);
+        EXPECT(builder.nonZeros() == triplets.size());
+
+        method::WeightMatrix W(6, 3);
+        builder.build(W);
+        EXPECT(builder.empty());
+
+        compare(W);
+    }
+
+    SECTION("row blocks") {
+        method::WeightMatrixBuilder a(6, 3);
+        method::WeightMatrixBuilder b(6, 3);
+        method::WeightMatrixBuilder c(6, 3);
+
+        a.add(1, 0, 0.25);
+        a.add(1, 2, 0.75);
+        b.add(3, 1, 0.1);
+        c.add(3, 2, 0.9);  // row split across blocks
+        c.add(5, 0, 1.);
+
+        method::WeightMatrixBuilder builder(6, 3);
+        builder.append(std::move(a));
+        builder.append(std::move(b));
+        builder.append(std::move(c));
+
+        method::WeightMatrix W(6, 3);
+        builder.build(W);
+
+        compare(W);
+    }
+
+    SECTION("rows out of order") {
+        method::WeightMatrixBuilder builder(6, 3);
+        builder.add(3, 0, 1.);
+        EXPECT_THROWS_AS(builder.add(1, 0, 1.), eckit::AssertionFailed);
+    }
+}
+
+
+CASE("WeightMatrixStructure") {
+    method::WeightMatrix W(5, 3);
+    W.setFromTriplets({{0, 0, 0.5}, {0, 1, 0.5}, {2, 0, 0.25}, {2, 2, 0.75}, {4, 1, 0.1}, {4, 2, 0.9}});
+
+    method::WeightMatrixStructure S(W);
+    EXPECT(S.matches(W));
+    EXPECT(S.rows() == 5);
+    EXPECT(S.nonZeros() == 6);
+
+    const std::vector<size_t> empty{1, 3};
+    EXPECT(S.emptyRows() == empty);
+    EXPECT(S.minRowNonZeros() == 2);
+    EXPECT(S.maxRowNonZeros() == 2);
+    EXPECT(S.fixedRowNonZeros() == 2);
+
+    SECTION("save/load") {
+        const eckit::PathName path("weight_matrix_structure.mat.structure");
+        method::WeightMatrixStructure(W, "digest").save(path);
+
+        method::WeightMatrixStructure T;
+        EXPECT_NOT(T.matches(W, "digest"));
+
+        T.load(path);
+        path.unlink();
+
+        EXPECT(T.digest() == "digest");
+        EXPECT(T.matches(W, "digest"));
+        EXPECT_NOT(T.matches(W, "another digest"));
+        EXPECT_NOT(T.matches(W));
+        EXPECT(T.emptyRows() == empty);
+        EXPECT(T.fixedRowNonZeros() == 2);
+    }
+
+    SECTION("variable row width") {
+        method::WeightMatrix V(2, 3);
+        V.setFromTriplets({{0, 0, 1.}, {1, 0, 0.25}, {1, 2, 0.75}});
+
+        method::WeightMatrixStructure U(V);
+        EXPECT(U.emptyRows().empty());
+        EXPECT(U.minRowNonZeros() == 1);
+        EXPECT(U.maxRowNonZeros() == 2);
+        EXPECT(U.fixedRowNonZeros() == 0);
+    }
+}
+
+
+CASE("WeightMatrixSinglePrecision") {
+    method::WeightMatrix W(4, 3);
+    W.setFromTriplets({{0, 0, 1.}, {1, 0, 0.25}, {1, 2, 0.75}, {3, 1, 0.1}, {3, 2, 0.9}});
+
+    method::WeightMatrixSinglePrecision F(W);
+    EXPECT(F.rows() == W.rows());
+    EXPECT(F.cols() == W.cols());
+    EXPECT(F.nonZeros() == W.nonZeros());
+
+    const std::vector<size_t> empty{2};
+    EXPECT(F.emptyRows() == empty);
+
+    // two columns, multiplied at once
+    eckit::linalg::Matrix A(3, 2);
+    A(0, 0) = 1.;
+    A(1, 0) = 2.;
+    A(2, 0) = 3.;
+    A(0, 1) = -1.;
+    A(1, 1) = 10.;
+    A(2, 1) = 100.;
+
+    eckit::linalg::Matrix B(4, 2);
+    B.setZero();
+
+    SECTION("multiply") {
+        F.multiply(A, B);
+
+        const double ref[4][2]{{1., -1.}, {2.5, 74.75}, {0., 0.}, {2.9, 91.}};
+        for (size_t r = 0; r < 4; ++r) {
+            for (size_t c = 0; c < 2; ++c) {
+                EXPECT(eckit::types::is_approximately_equal(B(r, c), ref[r][c], 1e-6));
+            }
+        }
+    }
+
+    SECTION("multiply (threaded)") {
+        eckit::linalg::Matrix C(4, 2);
+        F.multiply(A, B);
+        F.multiply(A, C, 3);
+        for (size_t r = 0; r < 4; ++r) {
+            for (size_t c = 0; c < 2; ++c) {
+                EXPECT(B(r, c) == C(r, c));
+            }
+        }
+    }
+
+    SECTION("save/load") {
+        const eckit::PathName path("weight_matrix_single_precision.mat32");
+        F.save(path);
+
+        method::WeightMatrixSinglePrecision G;
+        G.load(path);
+        path.unlink();
+
+        EXPECT(G.rows() == F.rows());
+        EXPECT(G.cols() == F.cols());
+        EXPECT(G.nonZeros() == F.nonZeros());
+
+        eckit::linalg::Matrix C(4, 2);
+        F.multiply(A, B);
+        G.multiply(A, C);
+        for (size_t r = 0; r < 4; ++r) {
+            for (size_t c = 0; c < 2; ++c) {
+                EXPECT(B(r, c) == C(r, c));
+            }
+        }
+    }
+}
+
+
+CASE("MatrixLoader") {
+    method::WeightMatrix W(4, 3);
+    W.setFromTriplets({{0, 0, 1.}, {1, 0, 0.25}, {1, 2, 0.75}, {3, 1, 0.1}, {3, 2, 0.9}});
+
+    const eckit::PathName path("weight_matrix_loader.mat");
+    W.save(path);
+
+    auto same = [](const method::WeightMatrix& A, const method::WeightMatrix& B) {
+        EXPECT(A.rows() == B.rows());
+        EXPECT(A.cols() == B.cols());
+        EXPECT(A.nonZeros() == B.nonZeros());
+        EXPECT(std::equal(A.outer(), A.outer() + A.rows() + 1, B.outer()));
+        EXPECT(std::equal(A.inner(), A.inner() + A.nonZeros(), B.inner()));
+        EXPECT(std::equal(A.data(), A.data() + A.nonZeros(), B.data()));
+    };
+
+    method::WeightMatrix F(caching::matrix::MatrixLoaderFactory::build("file-io", path));
+    same(W, F);
+
+    for (size_t pass = 0; pass < 2; ++pass) {
+        // first pass creates the memory image, second pass maps the existing one
+        method::WeightMatrix M(caching::matrix::MatrixLoaderFactory::build("mapped-memory", path));
+        EXPECT(caching::matrix::MappedMemoryLoader::imagePath(path).exists());
+        same(F, M);
+    }
+
+    caching::matrix::MappedMemoryLoader::imagePath(path).unlink();
+    path.unlink();
+}
+
+
+CASE("nonlinear::multiply") {
+    using method::nonlinear::NonLinear;
+    using method::nonlinear::NonLinearFactory;
+
+    // missing value compatible with simulated-missing-value default
+    const double missingValue = 9999.;
+    const MIRValuesVector values{1., missingValue, 3., missingValue, 5.};
+
+    method::WeightMatrix W(5, 5);
+    W.setFromTriplets({{0, 0, 0.5},
+                       {0, 1, 0.3},
+                       {0, 2, 0.2},
+                       {1, 1, 0.6},
+                       {1, 3, 0.4},
+                       {3, 2, 0.25},
+                       {3, 4, 0.75},
+                       {4, 0, 0.2},
+                       {4, 3, 0.1},
+                       {4, 4, 0.7}});
+    const std::vector<method::WeightMatrix::Scalar> weights(W.data(), W.data() + W.nonZeros());
+
+    method::DenseMatrix A(values.size(), 1);
+    for (size_t i = 0; i < values.size(); ++i) {
+        A(i, 0) = values[i];
+    }
+
+    param::SimpleParametrisation param;
+
+    for (const std::string name : {"no", "heaviest", "missing-if-all-missing", "missing-if-any-missing",
+                                   "missing-if-heaviest-missing", "simulated-missing-value"}) {
+        std::vector<std::unique_ptr<const NonLinear>> nonLinear;
+        nonLinear.emplace_back(NonLinearFactory::build(name, param));
+
+        // reference: treatment on a matrix copy, then multiplication
+        method::DenseMatrix Bref(W.rows(), 1);
+        method::WeightMatrix M(W);
+        nonLinear.front()->treatment(A, M, Bref, values, missingValue);
+
+        for (method::WeightMatrix::Size r = 0; r < M.rows(); ++r) {
+            Bref(r, 0) = 0.;
+            for (auto it = M.begin(r); it != M.end(r); ++it) {
+                Bref(r, 0) += *it * A(it.col(), 0);
+            }
+        }
+
+        // row-wise treatment during the multiplication, matrix is not modified
+        for (size_t threads : {1, 2}) {
+            method::DenseMatrix B(W.rows(), 1);
+            method::nonlinear::multiply(nonLinear, W, A, B, values, missingValue, threads);
+
+            EXPECT(std::equal(weights.begin(), weights.end(), W.data()));
+            for (method::WeightMatrix::Size r = 0; r < W.rows(); ++r) {
+                EXPECT(eckit::types::is_approximately_equal(B(r, 0), Bref(r, 0), 1e-12));
+            }
+        }
+    }
+}
+
+
+CASE("nonlinear::multiply (fixed row width)") {
+    using method::nonlinear::NonLinear;
+    using method::nonlinear::NonLinearFactory;
+
+    const double missingValue = 9999.;
+    const MIRValuesVector values{1., missingValue, 3., 4., 5.};
+
+    // three entries per row (as k-nearest neighbours, k=3)
+    method::WeightMatrix W(3, 5);
+    W.setFromTriplets({{0, 0, 0.5},
+                       {0, 1, 0.3},
+                       {0, 2, 0.2},
+                       {1, 1, 0.6},
+                       {1, 3, 0.3},
+                       {1, 4, 0.1},
+                       {2, 2, 0.25},
+                       {2, 3, 0.25},
+                       {2, 4, 0.5}});
+
+    method::WeightMatrixStructure S(W);
+    EXPECT(S.emptyRows().empty());
+    EXPECT(S.fixedRowNonZeros() == 3);
+
+    method::DenseMatrix A(values.size(), 1);
+    for (size_t i = 0; i < values.size(); ++i) {
+        A(i, 0) = values[i];
+    }
+
+    param::SimpleParametrisation param;
+
+    for (const std::string name : {"no", "heaviest", "missing-if-any-missing", "simulated-missing-value"}) {
+        std::vector<std::unique_ptr<const NonLinear>> nonLinear;
+        nonLinear.emplace_back(NonLinearFactory::build(name, param));
+
+        method::DenseMatrix Bref(W.rows(), 1);
+        method::nonlinear::multiply(nonLinear, W, A, Bref, values, missingValue, 1);
+
+        for (size_t threads : {1, 2}) {
+            method::DenseMatrix B(W.rows(), 1);
+            method::nonlinear::multiply(nonLinear, W, A, B, values, missingValue, threads, S.fixedRowNonZeros());
+
+            for (method::WeightMatrix::Size r = 0; r < W.rows(); ++r) {
+                EXPECT(B(r, 0) == Bref(r, 0));
+            }
+        }
+    }
+}
+
+
 }  // namespace mir::tests::unit
 
 